@@ -20,12 +20,27 @@
 #include "sg_Application.hpp"
 #include "Misc/sg_DefaultFiles.hpp"
 #include "sg_AudioManager.hpp"
+#include "sg_Benchmark.hpp"
+#include "sg_OfflineRenderer.hpp"
 
 namespace gris
 {
 //==============================================================================
-void SpatGrisApplication::initialise(juce::String const & /*commandLine*/)
+void SpatGrisApplication::initialise(juce::String const & commandLine)
 {
+    if (OfflineRenderer::isRenderCommandLine(commandLine)) {
+        auto const options{ OfflineRenderer::parseCommandLine(commandLine) };
+        setApplicationReturnValue(options ? OfflineRenderer{ *options }.run() : EXIT_FAILURE);
+        quit();
+        return;
+    }
+    if (Benchmark::isBenchmarkCommandLine(commandLine)) {
+        auto const benchmark{ Benchmark::fromCommandLine(commandLine) };
+        setApplicationReturnValue(benchmark ? benchmark->run() : EXIT_FAILURE);
+        quit();
+        return;
+    }
+
     // Make sure that the manual can be found.
     jassert(MANUAL_FILE_EN.existsAsFile());
     jassert(MANUAL_FILE_FR.existsAsFile());
@@ -43,7 +58,7 @@ void SpatGrisApplication::shutdown()
 //==============================================================================
 void SpatGrisApplication::systemRequestedQuit()
 {
-    if (mMainWindow->exitWinApp()) {
+    if (!mMainWindow || mMainWindow->exitWinApp()) {
         quit();
     }
 }
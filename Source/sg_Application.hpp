@@ -40,7 +40,7 @@ public:
     [[nodiscard]] const juce::String getApplicationName() override { return ProjectInfo::projectName; }
     [[nodiscard]] const juce::String getApplicationVersion() override { return ProjectInfo::versionString; }
     [[nodiscard]] bool moreThanOneInstanceAllowed() override { return true; }
-    void initialise(const juce::String & /*commandLine*/) override;
+    void initialise(const juce::String & commandLine) override;
     void shutdown() override;
     void systemRequestedQuit() override;
     void anotherInstanceStarted(const juce::String & /*commandLine*/) override {}
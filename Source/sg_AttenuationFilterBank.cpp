@@ -0,0 +1,154 @@
+/*
+ This file is part of SpatGRIS.
+
+ Developers: Gaël Lane Lépine, Samuel Béland, Olivier Bélanger, Nicolas Masson
+
+ SpatGRIS is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ SpatGRIS is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with SpatGRIS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sg_AttenuationFilterBank.hpp"
+
+#include "sg_AudioKernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace gris
+{
+namespace
+{
+constexpr auto TILE_SIZE = 64;
+#if JUCE_USE_SIMD
+constexpr auto GROUP_SIZE = kernels::VEC_SIZE;
+#else
+constexpr auto GROUP_SIZE = 1;
+#endif
+
+} // namespace
+
+//==============================================================================
+AttenuationFilterBank::AttenuationFilterBank(int const numSources) : mNumSources(numSources)
+{
+    jassert(numSources >= 0);
+    auto const paddedSize{ static_cast<size_t>((numSources + GROUP_SIZE - 1) / GROUP_SIZE * GROUP_SIZE) };
+    mGains.resize(paddedSize, 1.0f);
+    mTargetGains.resize(paddedSize, 1.0f);
+    mCoefficients.resize(paddedSize);
+    mTargetCoefficients.resize(paddedSize);
+    mLastOutputs.resize(paddedSize);
+    mTile.resize(static_cast<size_t>(TILE_SIZE * GROUP_SIZE));
+}
+
+//==============================================================================
+void AttenuationFilterBank::setTarget(int const source, float const gain, float const coefficient) noexcept
+{
+    jassert(source >= 0 && source < mNumSources);
+    jassert(coefficient >= 0.0f && coefficient < 1.0f);
+    mTargetGains[static_cast<size_t>(source)] = gain;
+    mTargetCoefficients[static_cast<size_t>(source)] = coefficient;
+}
+
+//==============================================================================
+void AttenuationFilterBank::process(float * const * const sources, int const numSamples) noexcept
+{
+    if (numSamples <= 0) {
+        return;
+    }
+    auto const inverseNumSamples{ 1.0f / static_cast<float>(numSamples) };
+
+    for (int groupStart{}; groupStart < mNumSources; groupStart += GROUP_SIZE) {
+        auto const groupSize{ std::min(GROUP_SIZE, mNumSources - groupStart) };
+        auto const state{ static_cast<size_t>(groupStart) };
+        auto * const tile{ mTile.data() };
+
+#if JUCE_USE_SIMD
+        using kernels::Vec;
+        auto gains{ kernels::load(mGains.data() + state) };
+        auto coefficients{ kernels::load(mCoefficients.data() + state) };
+        auto lastOutputs{ kernels::load(mLastOutputs.data() + state) };
+        auto const gainIncrements{ (kernels::load(mTargetGains.data() + state) - gains)
+                                   * Vec::expand(inverseNumSamples) };
+        auto const coefficientIncrements{ (kernels::load(mTargetCoefficients.data() + state) - coefficients)
+                                          * Vec::expand(inverseNumSamples) };
+        auto const ones{ Vec::expand(1.0f) };
+#else
+        auto gains{ mGains[state] };
+        auto coefficients{ mCoefficients[state] };
+        auto lastOutputs{ mLastOutputs[state] };
+        auto const gainIncrements{ (mTargetGains[state] - gains) * inverseNumSamples };
+        auto const coefficientIncrements{ (mTargetCoefficients[state] - coefficients) * inverseNumSamples };
+        auto const ones{ 1.0f };
+#endif
+
+        for (int tileStart{}; tileStart < numSamples; tileStart += TILE_SIZE) {
+            auto const tileSize{ std::min(TILE_SIZE, numSamples - tileStart) };
+
+            // The missing sources of the last group run on silence.
+            for (int lane{}; lane < GROUP_SIZE; ++lane) {
+                auto const * const input{ lane < groupSize ? sources[groupStart + lane] + tileStart : nullptr };
+                for (int i{}; i < tileSize; ++i) {
+                    tile[i * GROUP_SIZE + lane] = input != nullptr ? input[i] : 0.0f;
+                }
+            }
+
+            for (int i{}; i < tileSize; ++i) {
+                auto * const frame{ tile + i * GROUP_SIZE };
+#if JUCE_USE_SIMD
+                lastOutputs = kernels::load(frame) * (ones - coefficients) + lastOutputs * coefficients;
+                kernels::store(lastOutputs * gains, frame);
+#else
+                lastOutputs = *frame * (ones - coefficients) + lastOutputs * coefficients;
+                *frame = lastOutputs * gains;
+#endif
+                gains = gains + gainIncrements;
+                coefficients = coefficients + coefficientIncrements;
+            }
+
+            for (int lane{}; lane < groupSize; ++lane) {
+                auto * const output{ sources[groupStart + lane] + tileStart };
+                for (int i{}; i < tileSize; ++i) {
+                    output[i] = tile[i * GROUP_SIZE + lane];
+                }
+            }
+        }
+
+#if JUCE_USE_SIMD
+        kernels::store(lastOutputs, mLastOutputs.data() + state);
+#else
+        mLastOutputs[state] = lastOutputs;
+#endif
+    }
+
+    // Exactly on target, whatever the rounding of the ramps.
+    std::copy(mTargetGains.cbegin(), mTargetGains.cend(), mGains.begin());
+    std::copy(mTargetCoefficients.cbegin(), mTargetCoefficients.cend(), mCoefficients.begin());
+}
+
+//==============================================================================
+void AttenuationFilterBank::reset() noexcept
+{
+    std::copy(mTargetGains.cbegin(), mTargetGains.cend(), mGains.begin());
+    std::copy(mTargetCoefficients.cbegin(), mTargetCoefficients.cend(), mCoefficients.begin());
+    std::fill(mLastOutputs.begin(), mLastOutputs.end(), 0.0f);
+}
+
+//==============================================================================
+float AttenuationFilterBank::getCoefficient(float const frequency, double const sampleRate) noexcept
+{
+    jassert(sampleRate > 0.0);
+    auto const normalizedFrequency{ std::min(0.5, static_cast<double>(frequency) / sampleRate) };
+    return static_cast<float>(std::exp(-juce::MathConstants<double>::twoPi * normalizedFrequency));
+}
+
+} // namespace gris
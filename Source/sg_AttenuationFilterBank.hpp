@@ -0,0 +1,80 @@
+/*
+ This file is part of SpatGRIS.
+
+ Developers: Gaël Lane Lépine, Samuel Béland, Olivier Bélanger, Nicolas Masson
+
+ SpatGRIS is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ SpatGRIS is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with SpatGRIS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Data/sg_Macros.hpp"
+
+#include <JuceHeader.h>
+#include <vector>
+
+namespace gris
+{
+//==============================================================================
+/** The distance attenuation of many sources at once : a gain and a one-pole low-pass per source.
+ *
+ * A one-pole filter depends on its previous output, so a single source cannot be vectorized. The state of every source
+ * is kept as a structure of arrays instead, and each SIMD register runs a group of sources side by side (4 with SSE and
+ * NEON, 8 with AVX). The samples are interleaved tile by tile so that every lane reads its own source.
+ *
+ * The gains and the coefficients ramp linearly to their targets over a block, so moving sources do not click.
+ * Sources are plain indices starting at 0. All the memory is allocated by the constructor, so that setTarget() and
+ * process() can run on the audio thread.
+ *
+ * Nothing renders through it yet : the MBAP distance attenuation lives in AlgoGRIS and still filters one source after
+ * the other. For now, only the --attenuation benchmark uses it, to measure whether switching MBAP over would pay off
+ * and to check its output against the scalar filters.
+ */
+class AttenuationFilterBank
+{
+    int mNumSources{};
+    // Padded to a whole number of groups.
+    std::vector<float> mGains{};
+    std::vector<float> mTargetGains{};
+    std::vector<float> mCoefficients{};
+    std::vector<float> mTargetCoefficients{};
+    std::vector<float> mLastOutputs{};
+    // One tile of a group, interleaved.
+    std::vector<float> mTile{};
+
+public:
+    //==============================================================================
+    explicit AttenuationFilterBank(int numSources);
+    AttenuationFilterBank() = delete;
+    ~AttenuationFilterBank() = default;
+    SG_DELETE_COPY_AND_MOVE(AttenuationFilterBank)
+    //==============================================================================
+    /** Sets what a source ramps to during the next process(). A coefficient of 0 does not filter. */
+    void setTarget(int source, float gain, float coefficient) noexcept;
+    /** Attenuates every source in place. */
+    void process(float * const * sources, int numSamples) noexcept;
+    /** Jumps to the targets and forgets the past samples. */
+    void reset() noexcept;
+    //==============================================================================
+    [[nodiscard]] int getNumSources() const noexcept { return mNumSources; }
+    //==============================================================================
+    /** The coefficient of a one-pole low-pass with that cutoff frequency. */
+    [[nodiscard]] static float getCoefficient(float frequency, double sampleRate) noexcept;
+
+private:
+    //==============================================================================
+    JUCE_LEAK_DETECTOR(AttenuationFilterBank)
+};
+
+} // namespace gris
@@ -0,0 +1,151 @@
+/*
+ This file is part of SpatGRIS.
+
+ Developers: Gaël Lane Lépine, Samuel Béland, Olivier Bélanger, Nicolas Masson
+
+ SpatGRIS is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ SpatGRIS is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with SpatGRIS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+namespace gris
+{
+//==============================================================================
+/** Single-pass versions of the per-channel loops of the audio thread.
+ *
+ * Every kernel touches its samples once and uses the SIMD registers that JUCE picked for the target (SSE, AVX or NEON)
+ * when there are any. The loads and stores are unaligned : the channels can be device buffers that start anywhere.
+ */
+namespace kernels
+{
+#if JUCE_USE_SIMD
+using Vec = juce::dsp::SIMDRegister<float>;
+constexpr auto VEC_SIZE{ static_cast<int>(Vec::SIMDNumElements) };
+
+//==============================================================================
+inline Vec load(float const * const data) noexcept
+{
+    Vec result{};
+    std::memcpy(&result.value, data, sizeof(result.value));
+    return result;
+}
+
+//==============================================================================
+inline void store(Vec const & vec, float * const data) noexcept
+{
+    std::memcpy(data, &vec.value, sizeof(vec.value));
+}
+
+//==============================================================================
+inline Vec abs(Vec const & vec) noexcept
+{
+    return Vec::max(vec, Vec::expand(0.0f) - vec);
+}
+
+//==============================================================================
+inline float getMax(Vec const & vec, float const initialValue) noexcept
+{
+    auto result{ initialValue };
+    for (size_t i{}; i < Vec::SIMDNumElements; ++i) {
+        result = std::max(result, vec.get(i));
+    }
+    return result;
+}
+#endif
+
+//==============================================================================
+/** Multiplies the samples by a gain and returns the peak of the result. */
+inline float applyGainAndGetMagnitude(float * const samples, int const numSamples, float const gain) noexcept
+{
+    int i{};
+    auto peak{ 0.0f };
+#if JUCE_USE_SIMD
+    auto const gains{ Vec::expand(gain) };
+    auto peaks{ Vec::expand(0.0f) };
+    for (; i + VEC_SIZE <= numSamples; i += VEC_SIZE) {
+        auto const values{ load(samples + i) * gains };
+        store(values, samples + i);
+        peaks = Vec::max(peaks, abs(values));
+    }
+    peak = getMax(peaks, peak);
+#endif
+    for (; i < numSamples; ++i) {
+        samples[i] *= gain;
+        peak = std::max(peak, std::abs(samples[i]));
+    }
+    return peak;
+}
+
+//==============================================================================
+/** Copies the samples and returns their peak. */
+inline float copyAndGetMagnitude(float const * const source, float * const destination, int const numSamples) noexcept
+{
+    int i{};
+    auto peak{ 0.0f };
+#if JUCE_USE_SIMD
+    auto peaks{ Vec::expand(0.0f) };
+    for (; i + VEC_SIZE <= numSamples; i += VEC_SIZE) {
+        auto const values{ load(source + i) };
+        store(values, destination + i);
+        peaks = Vec::max(peaks, abs(values));
+    }
+    peak = getMax(peaks, peak);
+#endif
+    for (; i < numSamples; ++i) {
+        destination[i] = source[i];
+        peak = std::max(peak, std::abs(source[i]));
+    }
+    return peak;
+}
+
+//==============================================================================
+/** Adds the source samples to the destination with a gain that goes linearly from startGain to endGain. */
+inline void addWithGainRamp(float const * const source,
+                            float * const destination,
+                            int const numSamples,
+                            float const startGain,
+                            float const endGain) noexcept
+{
+    if (juce::exactlyEqual(startGain, endGain)) {
+        juce::FloatVectorOperations::addWithMultiply(destination, source, startGain, numSamples);
+        return;
+    }
+
+    auto const increment{ (endGain - startGain) / static_cast<float>(numSamples) };
+    int i{};
+#if JUCE_USE_SIMD
+    std::array<float, Vec::SIMDNumElements> firstGains{};
+    for (size_t lane{}; lane < firstGains.size(); ++lane) {
+        firstGains[lane] = startGain + increment * static_cast<float>(lane);
+    }
+    auto gains{ load(firstGains.data()) };
+    auto const gainsIncrement{ Vec::expand(increment * static_cast<float>(VEC_SIZE)) };
+    for (; i + VEC_SIZE <= numSamples; i += VEC_SIZE) {
+        store(load(destination + i) + load(source + i) * gains, destination + i);
+        gains = gains + gainsIncrement;
+    }
+#endif
+    for (; i < numSamples; ++i) {
+        destination[i] += source[i] * (startGain + increment * static_cast<float>(i));
+    }
+}
+
+} // namespace kernels
+} // namespace gris
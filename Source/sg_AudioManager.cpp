@@ -21,6 +21,9 @@
 
 #include "Data/sg_constants.hpp"
 #include "sg_AudioProcessor.hpp"
+#include "sg_ScopeGuard.hpp"
+
+#include <bitset>
 
 // #define SIMULATE_NO_AUDIO_DEVICES
 
@@ -51,9 +54,13 @@ AudioManager::AudioManager(juce::String const & deviceType,
                            int const pBufferSize,
                            tl::optional<StereoRouting> const & stereoRouting)
     : mStereoRouting(stereoRouting)
+    , mPublishedStereoRouting(stereoRouting)
 {
     JUCE_ASSERT_MESSAGE_THREAD;
 
+    mStereoOutputBuffer.clear();
+    mSilentBuffer.clear();
+
 #ifndef SIMULATE_NO_AUDIO_DEVICES
     auto const success{ tryInitAudioDevice(deviceType, inputDevice, outputDevice, pSampleRate, pBufferSize) };
 
@@ -69,6 +76,10 @@ AudioManager::AudioManager(juce::String const & deviceType,
     }
 #endif
 
+    if (auto const * audioDevice{ mAudioDeviceManager.getCurrentAudioDevice() }) {
+        mBufferSize = audioDevice->getCurrentBufferSizeSamples();
+    }
+
     mAudioDeviceManager.addAudioCallback(this);
 }
 
@@ -80,79 +91,129 @@ void AudioManager::audioDeviceIOCallbackWithContext(const float * const * inputC
                                                     int numSamples,
                                                     [[maybe_unused]] const juce::AudioIODeviceCallbackContext & context)
 {
-    jassert(numSamples <= mInputBuffer.MAX_NUM_SAMPLES);
-    jassert(numSamples <= mOutputBuffer.MAX_NUM_SAMPLES);
+    jassert(numSamples <= SourceAudioBuffer::MAX_NUM_SAMPLES);
+    jassert(numSamples <= SpeakerAudioBuffer::MAX_NUM_SAMPLES);
 
-    if (!mAudioProcessor || mIsPlayerLoading) {
+    if (!mAudioProcessor) {
         return;
     }
 
-    // clear buffers
-    mInputBuffer.silence();
-    if (mStereoRouting) {
-        mStereoOutputBuffer.clear();
+    auto & dropoutLedger{ mAudioProcessor->getDropoutLedger() };
+    if (mIsPlayerLoading) {
+        dropoutLedger.report(DropoutLedger::Cause::playerLoading);
+        return;
     }
-    // TODO: should not process if stereo mode is hrtf
-    mOutputBuffer.silence();
 
-    std::for_each_n(outputChannelData, totalNumOutputChannels, [numSamples](float * const data) {
-        std::fill_n(data, numSamples, 0.0f);
-    });
+    auto & profiler{ mAudioProcessor->getProfiler() };
+    profiler.startBlock(numSamples, mSampleRate);
+    auto const blockStart{ juce::Time::getHighResolutionTicks() };
+    auto const blockEnd{ make_scope_guard([&]() {
+        auto const load{ profiler.record(CallbackProfiler::Stage::total,
+                                         juce::Time::getHighResolutionTicks() - blockStart) };
+        if (load > 1.0f) {
+            dropoutLedger.report(DropoutLedger::Cause::deadlineOverrun, load);
+        }
+    }) };
 
-    juce::ScopedTryLock const lock{ mAudioProcessor->getLock() };
-    if (!lock.isLocked()) {
+    // pick up whatever the message thread published since the last block
+    auto const * const previousOutputBuffer{ mOutputBuffer.get() };
+    mAudioProcessor->updateAudioConfig(mInputBuffer, mOutputBuffer, mDeviceOutputBuffer);
+    if (mOutputBuffer.get() != previousOutputBuffer) {
+        mRecordersNeedDataPointers = true;
+    }
+    if (auto * const stereoRoutingUpdate{ mStereoRoutingUpdates.acquire() }) {
+        std::swap(*stereoRoutingUpdate, mStereoRouting);
+        mStereoRoutingUpdates.retire(stereoRoutingUpdate);
+    }
+
+    auto const clearOutputs = [&]() {
+        std::for_each_n(outputChannelData, totalNumOutputChannels, [numSamples](float * const data) {
+            std::fill_n(data, numSamples, 0.0f);
+        });
+    };
+
+    if (!mInputBuffer || !mOutputBuffer || !mAudioProcessor->getAudioData().config) {
+        clearOutputs();
         return;
     }
 
+    // clear buffers (the sources get cleared while they are filled)
+    mStereoOutputBuffer.setSize(2, mInputBuffer->getNumSamples(), false, false, true);
+    if (mStereoRouting) {
+        mStereoOutputBuffer.clear();
+    }
+
+    // The speakers can be rendered straight into the device outputs, unless they get reduced to stereo or recorded
+    // (the recorders keep pointers to the channels between blocks).
+    auto const renderInPlace{ !mStereoRouting && !mIsRecording && mDeviceOutputBuffer
+                              && mDeviceOutputBuffer->getNumSamples() == numSamples };
+    if (renderInPlace) {
+        referToDeviceOutputs(outputChannelData, totalNumOutputChannels, numSamples);
+    }
+    clearOutputsNotWrittenThisBlock(outputChannelData, totalNumOutputChannels, numSamples);
+    auto & outputBuffer{ renderInPlace ? *mDeviceOutputBuffer : *mOutputBuffer };
+    // TODO: should not process if stereo mode is hrtf
+    outputBuffer.silence();
+
     // if there is a player, copy audio file data to buffers, if not,
     // copy input data to buffers
-    if (isPlaying()) {
-        auto const numInputChannelsToCopy{ mTransportSources.size() };
-        for (int i{}; i < numInputChannelsToCopy; ++i) {
-            source_index_t const sourceIndex{ mTransportSourcesIndexes[i]->get() };
-            auto & buffer{ mInputBuffer[sourceIndex] };
-            juce::AudioSourceChannelInfo const info{ buffer };
-            mTransportSources.getUnchecked(i)->getNextAudioBlock(info);
-
-            // make sure all the audioTransportSources are in sync
-            if (i > 0) {
-                mTransportSources.getUnchecked(i)->setNextReadPosition(
-                    mTransportSources.getUnchecked(0)->getNextReadPosition());
+    {
+        CallbackProfiler::ScopedStage const stage{ profiler, CallbackProfiler::Stage::inputCopy };
+        if (isPlaying()) {
+            mInputBuffer->silence();
+            mAudioProcessor->invalidateIngestedInputs();
+            auto const numInputChannelsToCopy{ mTransportSources.size() };
+            for (int i{}; i < numInputChannelsToCopy; ++i) {
+                source_index_t const sourceIndex{ mTransportSourcesIndexes[i]->get() };
+                auto & buffer{ (*mInputBuffer)[sourceIndex] };
+                juce::AudioSourceChannelInfo const info{ buffer };
+                mTransportSources.getUnchecked(i)->getNextAudioBlock(info);
+
+                // make sure all the audioTransportSources are in sync
+                if (i > 0) {
+                    mTransportSources.getUnchecked(i)->setNextReadPosition(
+                        mTransportSources.getUnchecked(0)->getNextReadPosition());
+                }
             }
-        }
-    } else {
-        auto const numInputChannelsToCopy{ std::min(totalNumInputChannels, mInputBuffer.size()) };
-
-        auto activeChannel{ std::begin(mAudioProcessor->getAudioData().config->sourcesAudioConfig) };
-        for (int i{}; i < numInputChannelsToCopy; ++i) {
-            source_index_t const sourceIndex{ activeChannel->key };
-            auto const * sourceData{ inputChannelData[sourceIndex.get() - source_index_t::OFFSET] };
-            auto * destinationData{ mInputBuffer[sourceIndex].getWritePointer(0) };
-            std::copy_n(sourceData, numSamples, destinationData);
-            ++activeChannel;
+        } else {
+            mAudioProcessor->ingestInputs(inputChannelData, totalNumInputChannels, numSamples, *mInputBuffer);
         }
     }
 
     // do the actual processing
-    mAudioProcessor->processAudio(mInputBuffer, mOutputBuffer, mStereoOutputBuffer, mSampleRate);
+    mAudioProcessor->processAudio(*mInputBuffer, outputBuffer, mStereoOutputBuffer, mSampleRate);
 
     // copy buffers to output
-    if (mStereoRouting) {
-        jassert(mStereoOutputBuffer.getNumChannels() == 2);
-        auto const leftIndex{ mStereoRouting->left.template removeOffset<int>() };
-        auto const rightIndex{ mStereoRouting->right.template removeOffset<int>() };
-        if (leftIndex < totalNumOutputChannels) {
-            std::copy_n(mStereoOutputBuffer.getReadPointer(0), numSamples, outputChannelData[leftIndex]);
-        }
-        if (rightIndex < totalNumOutputChannels) {
-            std::copy_n(mStereoOutputBuffer.getReadPointer(1), numSamples, outputChannelData[rightIndex]);
+    {
+        CallbackProfiler::ScopedStage const stage{ profiler, CallbackProfiler::Stage::outputCopy };
+        if (mStereoRouting) {
+            jassert(mStereoOutputBuffer.getNumChannels() == 2);
+            auto const leftIndex{ mStereoRouting->left.template removeOffset<int>() };
+            auto const rightIndex{ mStereoRouting->right.template removeOffset<int>() };
+            if (leftIndex < totalNumOutputChannels) {
+                std::copy_n(mStereoOutputBuffer.getReadPointer(0), numSamples, outputChannelData[leftIndex]);
+            }
+            if (rightIndex < totalNumOutputChannels) {
+                std::copy_n(mStereoOutputBuffer.getReadPointer(1), numSamples, outputChannelData[rightIndex]);
+            }
+        } else if (!renderInPlace) {
+            mOutputBuffer->copyToPhysicalOutput(outputChannelData, totalNumOutputChannels);
         }
-    } else {
-        mOutputBuffer.copyToPhysicalOutput(outputChannelData, totalNumOutputChannels);
     }
 
     // Record
     if (mIsRecording) {
+        CallbackProfiler::ScopedStage const stage{ profiler, CallbackProfiler::Stage::recorders };
+        // Only held by stopRecording() while it tears the recorders down : the block has already been played, it is
+        // just not recorded.
+        juce::ScopedTryLock const lock{ mRecordersLock };
+        if (!lock.isLocked()) {
+            dropoutLedger.report(DropoutLedger::Cause::lockContention);
+            return;
+        }
+        if (mRecordersNeedDataPointers.exchange(false)) {
+            updateRecordersDataPointers();
+        }
         auto const stopRecordingAndDisplayError = [this]() {
             stopRecording();
             juce::AlertWindow::showMessageBox(
@@ -165,6 +226,7 @@ void AudioManager::audioDeviceIOCallbackWithContext(const float * const * inputC
             jassert(recorder->audioFormatWriterPtr->getNumChannels() == recorder->dataToRecord.size());
             auto const success{ recorder->threadedWriter->write(recorder->dataToRecord.data(), numSamples) };
             if (!success) {
+                dropoutLedger.report(DropoutLedger::Cause::recorderOverflow);
                 jassertfalse;
                 stopRecordingAndDisplayError();
             }
@@ -256,6 +318,9 @@ void AudioManager::registerAudioProcessor(AudioProcessor * audioProcessor)
 {
     JUCE_ASSERT_MESSAGE_THREAD;
     mAudioProcessor = audioProcessor;
+    if (mAudioProcessor && mBufferSize > 0) {
+        mAudioProcessor->setBufferSize(mBufferSize);
+    }
 }
 
 //==============================================================================
@@ -487,6 +552,8 @@ bool AudioManager::prepareToRecord(RecordingParameters const & recordingParams)
     jassert(std::is_sorted(recordingParams.speakersToRecord.begin(), recordingParams.speakersToRecord.end()));
     mNumSamplesRecorded = 0;
     mRecorders.clearQuick(true);
+    // The output buffer belongs to the audio thread : it fills in the pointers before recording the first block.
+    mRecordersNeedDataPointers = true;
 
     auto * currentAudioDevice{ mAudioDeviceManager.getCurrentAudioDevice() };
     jassert(currentAudioDevice);
@@ -523,6 +590,7 @@ bool AudioManager::prepareToRecord(RecordingParameters const & recordingParams)
              double const sampleRate_,
              int const bufferSize_,
              juce::Array<float const *> dataToRecord,
+             juce::Array<output_patch_t> speakers,
              juce::TimeSliceThread & timeSlicedThread) -> std::unique_ptr<FileRecorder> {
         juce::StringPairArray const metaData{}; // lets leave this empty for now
 
@@ -551,6 +619,7 @@ bool AudioManager::prepareToRecord(RecordingParameters const & recordingParams)
         result->audioFormatWriterPtr = audioFormatWriterPtr;
         result->threadedWriter = std::move(threadedWriter);
         result->dataToRecord = std::move(dataToRecord);
+        result->speakers = std::move(speakers);
         return result;
     };
 
@@ -581,7 +650,7 @@ bool AudioManager::prepareToRecord(RecordingParameters const & recordingParams)
         }
 
         jassert(recordingParams.options.fileType == RecordingFileType::mono);
-        if (mStereoRouting) {
+        if (mPublishedStereoRouting) {
             return getSeparateStereoFilePaths();
         }
 
@@ -634,6 +703,7 @@ bool AudioManager::prepareToRecord(RecordingParameters const & recordingParams)
                                            recordingParams.sampleRate,
                                            recordingBufferSize,
                                            std::move(dataToRecord),
+                                           juce::Array<output_patch_t>{},
                                            mRecordersThread) };
         if (!recorder) {
             return false;
@@ -651,6 +721,7 @@ bool AudioManager::prepareToRecord(RecordingParameters const & recordingParams)
                                                recordingParams.sampleRate,
                                                recordingBufferSize,
                                                juce::Array<float const *>{ mStereoOutputBuffer.getReadPointer(i) },
+                                               juce::Array<output_patch_t>{},
                                                mRecordersThread) };
             if (!recorder) {
                 return false;
@@ -663,12 +734,14 @@ bool AudioManager::prepareToRecord(RecordingParameters const & recordingParams)
     auto const makeInterleavedSpeakersRecorder = [&]() {
         jassert(filePaths.size() == 1);
         auto const & filePath{ filePaths[0] };
-        auto dataToRecord = mOutputBuffer.getArrayOfReadPointers(recordingParams.speakersToRecord);
+        juce::Array<float const *> dataToRecord{};
+        dataToRecord.insertMultiple(0, mSilentBuffer.getReadPointer(0), recordingParams.speakersToRecord.size());
         auto recordingInfo{ MAKE_RECORDING_INFO(filePath,
                                                 *audioFormat,
                                                 recordingParams.sampleRate,
                                                 recordingBufferSize,
                                                 std::move(dataToRecord),
+                                                recordingParams.speakersToRecord,
                                                 mRecordersThread) };
         if (!recordingInfo) {
             return false;
@@ -682,13 +755,13 @@ bool AudioManager::prepareToRecord(RecordingParameters const & recordingParams)
         for (int i{}; i < recordingParams.speakersToRecord.size(); ++i) {
             auto const outputPatch{ recordingParams.speakersToRecord[i] };
             auto const & filePath{ filePaths[i] };
-            juce::Array<float const *> dataToRecord{};
-            dataToRecord.add(mOutputBuffer[outputPatch].getReadPointer(0));
+            juce::Array<float const *> dataToRecord{ mSilentBuffer.getReadPointer(0) };
             auto recordingInfo{ MAKE_RECORDING_INFO(filePath,
                                                     *audioFormat,
                                                     recordingParams.sampleRate,
                                                     recordingBufferSize,
                                                     std::move(dataToRecord),
+                                                    juce::Array<output_patch_t>{ outputPatch },
                                                     mRecordersThread) };
             if (!recordingInfo) {
                 return false;
@@ -700,7 +773,7 @@ bool AudioManager::prepareToRecord(RecordingParameters const & recordingParams)
 
     auto const makeRecorders = [&]() {
         auto const isInterleaved{ recordingParams.options.fileType == RecordingFileType::interleaved };
-        if (mStereoRouting) {
+        if (mPublishedStereoRouting) {
             if (isInterleaved) {
                 return makeInterleavedStereoRecorder();
             }
@@ -737,8 +810,7 @@ void AudioManager::startRecording()
 void AudioManager::stopRecording()
 {
     JUCE_ASSERT_MESSAGE_THREAD;
-    jassert(mAudioProcessor);
-    juce::ScopedLock const sl{ mAudioProcessor->getLock() };
+    juce::ScopedLock const lock{ mRecordersLock };
     // threadedWriters will flush their data before going off
     mRecorders.clear(true);
     mRecordersThread.stopThread(-1);
@@ -746,40 +818,89 @@ void AudioManager::stopRecording()
 }
 
 //==============================================================================
-void AudioManager::initInputBuffer(juce::Array<source_index_t> const & sources)
+void AudioManager::setBufferSize(int const newBufferSize)
 {
     JUCE_ASSERT_MESSAGE_THREAD;
     jassert(mAudioProcessor);
-    juce::ScopedLock const lock{ mAudioProcessor->getLock() };
-    mInputBuffer.init(sources);
+    jassert(newBufferSize <= SpeakerAudioBuffer::MAX_NUM_SAMPLES);
+    mBufferSize = newBufferSize;
+    mAudioProcessor->setBufferSize(newBufferSize);
 }
 
 //==============================================================================
-void AudioManager::initOutputBuffer(juce::Array<output_patch_t> const & speakers)
+void AudioManager::setStereoRouting(tl::optional<StereoRouting> const & stereoRouting)
 {
     JUCE_ASSERT_MESSAGE_THREAD;
-    jassert(mAudioProcessor);
-    juce::ScopedLock const lock{ mAudioProcessor->getLock() };
-    mOutputBuffer.init(speakers);
+    mPublishedStereoRouting = stereoRouting;
+    mStereoRoutingUpdates.publish(std::make_unique<tl::optional<StereoRouting>>(stereoRouting));
 }
 
 //==============================================================================
-void AudioManager::setBufferSize(int const newBufferSize)
+void AudioManager::referToDeviceOutputs(float * const * outputChannelData,
+                                        int const totalNumOutputChannels,
+                                        int const numSamples) noexcept
 {
-    JUCE_ASSERT_MESSAGE_THREAD;
-    jassert(mAudioProcessor);
-    juce::ScopedLock const lock{ mAudioProcessor->getLock() };
-    mInputBuffer.setNumSamples(newBufferSize);
-    mOutputBuffer.setNumSamples(newBufferSize);
-    mStereoOutputBuffer.setSize(2, newBufferSize);
+    jassert(mDeviceOutputBuffer && mOutputBuffer);
+
+    // The device channels that do get a speaker are cleared by silence().
+    for (auto const channel : *mDeviceOutputBuffer) {
+        auto const outputIndex{ channel.key.template removeOffset<int>() };
+        if (outputIndex < totalNumOutputChannels) {
+            channel.value->setDataToReferTo(outputChannelData + outputIndex, 1, numSamples);
+            continue;
+        }
+        // The device does not have that output : it gets rendered and dropped, like copyToPhysicalOutput() does.
+        auto & fallback{ (*mOutputBuffer)[channel.key] };
+        channel.value->setDataToReferTo(fallback.getArrayOfWritePointers(), 1, numSamples);
+    }
 }
 
 //==============================================================================
-void AudioManager::setStereoRouting(tl::optional<StereoRouting> const & stereoRouting)
+void AudioManager::clearOutputsNotWrittenThisBlock(float * const * outputChannelData,
+                                                   int const totalNumOutputChannels,
+                                                   int const numSamples) const noexcept
 {
-    JUCE_ASSERT_MESSAGE_THREAD;
-    juce::ScopedLock const lock{ mAudioProcessor->getLock() };
-    mStereoRouting = stereoRouting;
+    // Whether they are rendered in place or copied at the end, these outputs get all of their samples written.
+    std::bitset<MAX_NUM_SPEAKERS> writtenOutputs{};
+    auto const markAsWritten = [&](int const outputIndex) {
+        if (outputIndex < totalNumOutputChannels && static_cast<size_t>(outputIndex) < writtenOutputs.size()) {
+            writtenOutputs.set(static_cast<size_t>(outputIndex));
+        }
+    };
+    if (mStereoRouting) {
+        markAsWritten(mStereoRouting->left.template removeOffset<int>());
+        markAsWritten(mStereoRouting->right.template removeOffset<int>());
+    } else if (mOutputBuffer->getNumSamples() == numSamples) {
+        for (auto const channel : *mOutputBuffer) {
+            markAsWritten(channel.key.template removeOffset<int>());
+        }
+    }
+
+    for (int i{}; i < totalNumOutputChannels; ++i) {
+        if (static_cast<size_t>(i) >= writtenOutputs.size() || !writtenOutputs.test(static_cast<size_t>(i))) {
+            std::fill_n(outputChannelData[i], numSamples, 0.0f);
+        }
+    }
+}
+
+//==============================================================================
+void AudioManager::updateRecordersDataPointers() noexcept
+{
+    // The stereo recorders point to mStereoOutputBuffer, which never moves.
+    for (auto * recorder : mRecorders) {
+        for (int i{}; i < recorder->speakers.size(); ++i) {
+            auto const speaker{ recorder->speakers.getUnchecked(i) };
+            // A speaker that was removed while recording gets recorded as silence.
+            auto const * data{ mSilentBuffer.getReadPointer(0) };
+            for (auto const channel : *mOutputBuffer) {
+                if (channel.key == speaker) {
+                    data = channel.value->getReadPointer(0);
+                    break;
+                }
+            }
+            recorder->dataToRecord.getReference(i) = data;
+        }
+    }
 }
 
 //==============================================================================
@@ -802,6 +923,12 @@ void AudioManager::audioDeviceStopped()
     // when AudioProcessor will be a real AudioSource, releaseResources() should be called here.
 }
 
+//==============================================================================
+bool AudioManager::isInitialized() noexcept
+{
+    return mInstance != nullptr;
+}
+
 //==============================================================================
 AudioManager & AudioManager::getInstance()
 {
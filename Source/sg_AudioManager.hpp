@@ -22,6 +22,7 @@
 #include "Containers/sg_TaggedAudioBuffer.hpp"
 #include "Data/sg_AudioStructs.hpp"
 #include "Data/sg_LogicStrucs.hpp"
+#include "sg_RealtimeExchange.hpp"
 
 #include <JuceHeader.h>
 
@@ -54,6 +55,9 @@ class AudioManager final : juce::AudioSourcePlayer
         // A collection of pointers to the buffers that will get recorded on disk. Note that this is NOT null terminated
         // : all pointers are non-null and valid.
         juce::Array<float const *> dataToRecord{};
+        // The speakers that dataToRecord points to, so that the pointers can be refreshed by the audio thread when the
+        // output buffer gets replaced. Empty when recording the stereo reduction.
+        juce::Array<output_patch_t> speakers{};
     };
 
     //==============================================================================
@@ -80,13 +84,25 @@ private:
     //==============================================================================
     AudioProcessor * mAudioProcessor{};
     juce::AudioDeviceManager mAudioDeviceManager{};
-    SourceAudioBuffer mInputBuffer{};
-    SpeakerAudioBuffer mOutputBuffer{};
-
-    juce::AudioBuffer<float> mStereoOutputBuffer{};
+    // Owned by the audio thread : new ones are published through AudioProcessor::setAudioConfig().
+    std::unique_ptr<SourceAudioBuffer> mInputBuffer{};
+    std::unique_ptr<SpeakerAudioBuffer> mOutputBuffer{};
+    // Same speakers as mOutputBuffer, rendered straight into the device outputs when the layout allows it.
+    std::unique_ptr<SpeakerAudioBuffer> mDeviceOutputBuffer{};
+    int mBufferSize{};
+
+    // Allocated once for the maximum block size so that its channels never move.
+    juce::AudioBuffer<float> mStereoOutputBuffer{ 2, SpeakerAudioBuffer::MAX_NUM_SAMPLES };
+    juce::AudioBuffer<float> mSilentBuffer{ 1, SpeakerAudioBuffer::MAX_NUM_SAMPLES };
+    // The audio thread uses mStereoRouting, the message thread mPublishedStereoRouting.
     tl::optional<StereoRouting> mStereoRouting{};
+    tl::optional<StereoRouting> mPublishedStereoRouting{};
+    RealtimeExchange<tl::optional<StereoRouting>> mStereoRoutingUpdates{};
     // Recording
-    bool mIsRecording{};
+    std::atomic<bool> mIsRecording{};
+    std::atomic<bool> mRecordersNeedDataPointers{};
+    // The only lock that the audio thread takes, and only while recording.
+    juce::CriticalSection mRecordersLock{};
     juce::Atomic<int64_t> mNumSamplesRecorded{};
     juce::OwnedArray<FileRecorder> mRecorders{};
     juce::TimeSliceThread mRecordersThread{ "SpatGRIS recording thread" };
@@ -136,8 +152,6 @@ public:
     juce::AudioFormatManager & getAudioFormatManager();
     juce::Array<juce::File> & getAudioFiles();
 
-    void initInputBuffer(juce::Array<source_index_t> const & sources);
-    void initOutputBuffer(juce::Array<output_patch_t> const & speakers);
     void setBufferSize(int newBufferSize);
     void setStereoRouting(tl::optional<StereoRouting> const & stereoRouting);
     //==============================================================================
@@ -159,6 +173,7 @@ public:
                      int bufferSize,
                      tl::optional<StereoRouting> const & stereoRouting);
     static void free();
+    [[nodiscard]] static bool isInitialized() noexcept;
     [[nodiscard]] static AudioManager & getInstance();
 
 private:
@@ -175,6 +190,11 @@ private:
                                           juce::String const & outputDevice,
                                           double requestedSampleRate,
                                           int requestedBufferSize);
+    void updateRecordersDataPointers() noexcept;
+    void referToDeviceOutputs(float * const * outputChannelData, int totalNumOutputChannels, int numSamples) noexcept;
+    void clearOutputsNotWrittenThisBlock(float * const * outputChannelData,
+                                         int totalNumOutputChannels,
+                                         int numSamples) const noexcept;
     //==============================================================================
     double mSampleRate{};
 
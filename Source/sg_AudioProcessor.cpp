@@ -24,10 +24,28 @@
 #include "Containers/sg_TaggedAudioBuffer.hpp"
 #include "Data/sg_Narrow.hpp"
 #include "Data/sg_constants.hpp"
+#include "sg_AudioKernels.hpp"
 #include "sg_AudioManager.hpp"
 #include "sg_MainComponent.hpp"
 
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <utility>
+
+namespace
+{
+/** Short enough for a chunk of a channel to stay in the L1 cache between the high-pass and the gain. */
+constexpr auto OUTPUT_CHUNK_SIZE = 64;
+/** Of a crossfade between two algorithms, or of each half of a fade through silence. */
+constexpr auto CROSSFADE_DURATION_SECONDS = 0.02;
+
+//==============================================================================
+int getCrossfadeLength(double const sampleRate) noexcept
+{
+    return std::max(1, juce::roundToInt(sampleRate * CROSSFADE_DURATION_SECONDS));
+}
+} // namespace
 
 namespace gris
 {
@@ -36,30 +54,368 @@ AudioProcessor::AudioProcessor()
 {
     // Initialize pink noise
     srand(static_cast<unsigned>(time(nullptr))); // NOLINT(cert-msc51-cpp)
+
+    mCrossfadeStereoBuffer.clear();
+    mCrossfadeGains.clear();
+}
+
+//==============================================================================
+void AudioConfigUpdate::mergeOlder(AudioConfigUpdate & older) noexcept
+{
+    if (!config) {
+        config = std::move(older.config);
+    }
+    if (!inputBuffer) {
+        inputBuffer = std::move(older.inputBuffer);
+    }
+    if (!outputBuffer) {
+        outputBuffer = std::move(older.outputBuffer);
+        crossfadeBuffer = std::move(older.crossfadeBuffer);
+        deviceOutputBuffer = std::move(older.deviceOutputBuffer);
+    }
+    if (!spatAlgorithm) {
+        spatAlgorithm = std::move(older.spatAlgorithm);
+    }
 }
 
 //==============================================================================
 void AudioProcessor::setAudioConfig(std::unique_ptr<AudioConfig> newAudioConfig)
 {
     JUCE_ASSERT_MESSAGE_THREAD;
-    juce::ScopedLock const lock{ mLock };
 
-    if (!mAudioData.config || !mAudioData.config->sourcesAudioConfig.hasSameKeys(newAudioConfig->sourcesAudioConfig)) {
-        AudioManager::getInstance().initInputBuffer(newAudioConfig->sourcesAudioConfig.getKeys());
+    auto update{ std::make_unique<AudioConfigUpdate>() };
+
+    auto const sources{ newAudioConfig->sourcesAudioConfig.getKeys() };
+    if (sources != mPublishedSources) {
+        update->inputBuffer = makeInputBuffer(sources);
+        mPublishedSources = sources;
     }
-    if (!mAudioData.config
-        || !mAudioData.config->speakersAudioConfig.hasSameKeys(newAudioConfig->speakersAudioConfig)) {
-        AudioManager::getInstance().initOutputBuffer(newAudioConfig->speakersAudioConfig.getKeys());
+    auto const speakers{ newAudioConfig->speakersAudioConfig.getKeys() };
+    if (speakers != mPublishedSpeakers) {
+        update->outputBuffer = makeOutputBuffer(speakers);
+        update->crossfadeBuffer = makeOutputBuffer(speakers);
+        update->deviceOutputBuffer = makeDeviceOutputBuffer(speakers, *update->outputBuffer);
+        mPublishedSpeakers = speakers;
     }
 
-    mAudioData.config = std::move(newAudioConfig);
+    update->config = std::move(newAudioConfig);
+    update->spatAlgorithm = std::move(mPendingSpatAlgorithm);
+    publish(std::move(update));
+}
+
+//==============================================================================
+void AudioProcessor::setSpatAlgorithm(std::unique_ptr<AbstractSpatAlgorithm> spatAlgorithm)
+{
+    JUCE_ASSERT_MESSAGE_THREAD;
+    jassert(spatAlgorithm);
 
-    std::fill(mAudioData.state.sourcesAudioState.begin(), mAudioData.state.sourcesAudioState.end(), SourceAudioState{});
+    mLatestSpatAlgorithm = spatAlgorithm.get();
+    mPendingSpatAlgorithm = std::move(spatAlgorithm);
 }
 
 //==============================================================================
-void AudioProcessor::processInputPeaks(SourceAudioBuffer & inputBuffer, SourcePeaks & peaks) const noexcept
+void AudioProcessor::setBufferSize(int const bufferSize)
 {
+    JUCE_ASSERT_MESSAGE_THREAD;
+    jassert(bufferSize <= SpeakerAudioBuffer::MAX_NUM_SAMPLES);
+
+    mBufferSize = bufferSize;
+    auto update{ std::make_unique<AudioConfigUpdate>() };
+    update->inputBuffer = makeInputBuffer(mPublishedSources);
+    update->outputBuffer = makeOutputBuffer(mPublishedSpeakers);
+    update->crossfadeBuffer = makeOutputBuffer(mPublishedSpeakers);
+    update->deviceOutputBuffer = makeDeviceOutputBuffer(mPublishedSpeakers, *update->outputBuffer);
+    publish(std::move(update));
+}
+
+//==============================================================================
+void AudioProcessor::publish(std::unique_ptr<AudioConfigUpdate> update)
+{
+    JUCE_ASSERT_MESSAGE_THREAD;
+
+    // An update that the audio thread did not get to yet might contain buffers that this one does not.
+    if (auto const olderUpdate{ mConfigUpdates.takeBackPending() }) {
+        update->mergeOlder(*olderUpdate);
+    }
+    mConfigUpdates.publish(std::move(update));
+}
+
+//==============================================================================
+std::unique_ptr<SourceAudioBuffer> AudioProcessor::makeInputBuffer(juce::Array<source_index_t> const & sources) const
+{
+    JUCE_ASSERT_MESSAGE_THREAD;
+    auto buffer{ std::make_unique<SourceAudioBuffer>() };
+    buffer->init(sources);
+    if (mBufferSize > 0) {
+        buffer->setNumSamples(mBufferSize);
+    }
+    return buffer;
+}
+
+//==============================================================================
+std::unique_ptr<SpeakerAudioBuffer> AudioProcessor::makeOutputBuffer(juce::Array<output_patch_t> const & speakers) const
+{
+    JUCE_ASSERT_MESSAGE_THREAD;
+    auto buffer{ std::make_unique<SpeakerAudioBuffer>() };
+    buffer->init(speakers);
+    if (mBufferSize > 0) {
+        buffer->setNumSamples(mBufferSize);
+    }
+    return buffer;
+}
+
+//==============================================================================
+std::unique_ptr<SpeakerAudioBuffer>
+    AudioProcessor::makeDeviceOutputBuffer(juce::Array<output_patch_t> const & speakers,
+                                           SpeakerAudioBuffer & outputBuffer) const
+{
+    JUCE_ASSERT_MESSAGE_THREAD;
+    auto buffer{ makeOutputBuffer(speakers) };
+    // Let go of the storage here : pointing a channel somewhere else for the first time would free it on the audio
+    // thread.
+    for (auto const channel : *buffer) {
+        auto & fallback{ outputBuffer[channel.key] };
+        channel.value->setDataToReferTo(fallback.getArrayOfWritePointers(), 1, fallback.getNumSamples());
+    }
+    return buffer;
+}
+
+//==============================================================================
+void AudioProcessor::updateAudioConfig(std::unique_ptr<SourceAudioBuffer> & inputBuffer,
+                                       std::unique_ptr<SpeakerAudioBuffer> & outputBuffer,
+                                       std::unique_ptr<SpeakerAudioBuffer> & deviceOutputBuffer) noexcept
+{
+    if (mFadingOutUpdate != nullptr) {
+        // The outgoing algorithm still needs the current config and buffers : wait for the crossfade to end.
+        return;
+    }
+
+    AudioConfigUpdate * update{};
+    if (mHeldUpdate != nullptr) {
+        if (mBufferFade == BufferFade::fadingOut) {
+            return;
+        }
+        update = std::exchange(mHeldUpdate, nullptr);
+    } else {
+        update = mConfigUpdates.acquire();
+        if (update == nullptr) {
+            return;
+        }
+        // The outgoing algorithm cannot be crossfaded into channels that it does not know about : fade it out to
+        // silence before swapping the buffers, and fade the new ones in.
+        auto const changesBuffers{ update->inputBuffer || update->outputBuffer };
+        if (update->spatAlgorithm && changesBuffers && mSpatAlgorithm) {
+            mHeldUpdate = update;
+            mBufferFade = BufferFade::fadingOut;
+            mBufferFadePosition = 0;
+            return;
+        }
+    }
+
+    // Swapping leaves the previous config and buffers in the update, to be freed by the message thread.
+    if (update->config) {
+        std::swap(update->config, mAudioData.config);
+        std::fill(mAudioData.state.sourcesAudioState.begin(),
+                  mAudioData.state.sourcesAudioState.end(),
+                  SourceAudioState{});
+    }
+    if (update->inputBuffer) {
+        std::swap(update->inputBuffer, inputBuffer);
+        ++mInputBufferGeneration;
+    }
+    if (update->outputBuffer) {
+        std::swap(update->outputBuffer, outputBuffer);
+        std::swap(update->crossfadeBuffer, mCrossfadeBuffer);
+        std::swap(update->deviceOutputBuffer, deviceOutputBuffer);
+    }
+    if (update->spatAlgorithm) {
+        std::swap(update->spatAlgorithm, mSpatAlgorithm);
+        // The outgoing algorithm can only keep rendering if the channels it knows about are still there.
+        auto const canCrossfade{ update->spatAlgorithm && !update->inputBuffer && !update->outputBuffer
+                                 && mCrossfadeBuffer };
+        if (canCrossfade) {
+            mFadingOutUpdate = update;
+            mCrossfadePosition = 0;
+            return;
+        }
+    }
+    if (mBufferFade == BufferFade::silent) {
+        mBufferFade = BufferFade::fadingIn;
+        mBufferFadePosition = 0;
+    }
+
+    mConfigUpdates.retire(update);
+}
+
+//==============================================================================
+void AudioProcessor::endCrossfade() noexcept
+{
+    if (mFadingOutUpdate == nullptr) {
+        return;
+    }
+    mConfigUpdates.retire(mFadingOutUpdate);
+    mFadingOutUpdate = nullptr;
+}
+
+//==============================================================================
+void AudioProcessor::processBufferFade(SpeakerAudioBuffer & speakerBuffer,
+                                       juce::AudioBuffer<float> & stereoBuffer,
+                                       double const sampleRate) noexcept
+{
+    if (mBufferFade == BufferFade::none) {
+        return;
+    }
+
+    // Equal-power gains, like the crossfade
+    auto const numSamples{ speakerBuffer.getNumSamples() };
+    auto const fadeLength{ getCrossfadeLength(sampleRate) };
+    auto * const gains{ mCrossfadeGains.getWritePointer(0) };
+    for (int i{}; i < numSamples; ++i) {
+        auto const progress{ std::min(1.0f,
+                                      static_cast<float>(mBufferFadePosition + i) / static_cast<float>(fadeLength)) };
+        auto const angle{ progress * juce::MathConstants<float>::halfPi };
+        gains[i] = mBufferFade == BufferFade::fadingIn ? std::sin(angle) : std::cos(angle);
+    }
+
+    for (auto const channel : speakerBuffer) {
+        juce::FloatVectorOperations::multiply(channel.value->getWritePointer(0), gains, numSamples);
+    }
+    if (mAudioData.config->isStereo) {
+        for (int i{}; i < 2; ++i) {
+            juce::FloatVectorOperations::multiply(stereoBuffer.getWritePointer(i), gains, numSamples);
+        }
+    }
+
+    mBufferFadePosition += numSamples;
+    if (mBufferFadePosition < fadeLength) {
+        return;
+    }
+    if (mBufferFade == BufferFade::fadingOut) {
+        // Stays silent until updateAudioConfig() swaps the held update in.
+        mBufferFade = BufferFade::silent;
+    } else if (mBufferFade == BufferFade::fadingIn) {
+        mBufferFade = BufferFade::none;
+    }
+}
+
+//==============================================================================
+void AudioProcessor::processSpatAlgorithms(SourceAudioBuffer & sourceBuffer,
+                                           SpeakerAudioBuffer & speakerBuffer,
+                                           juce::AudioBuffer<float> & stereoBuffer,
+                                           SourcePeaks const & sourcePeaks,
+                                           double const sampleRate) noexcept
+{
+    if (!mSpatAlgorithm) {
+        return;
+    }
+
+    mSpatAlgorithm->process(*mAudioData.config, sourceBuffer, speakerBuffer, stereoBuffer, sourcePeaks, nullptr);
+
+    if (mFadingOutUpdate == nullptr) {
+        return;
+    }
+
+    // Render the outgoing algorithm on the side
+    auto const numSamples{ speakerBuffer.getNumSamples() };
+    auto & fadingOutBuffer{ *mCrossfadeBuffer };
+    fadingOutBuffer.setNumSamples(numSamples);
+    fadingOutBuffer.silence();
+    mCrossfadeStereoBuffer.setSize(2, numSamples, false, false, true);
+    mCrossfadeStereoBuffer.clear();
+    mFadingOutUpdate->spatAlgorithm->process(*mAudioData.config,
+                                             sourceBuffer,
+                                             fadingOutBuffer,
+                                             mCrossfadeStereoBuffer,
+                                             sourcePeaks,
+                                             nullptr);
+
+    // Equal-power gains
+    auto const crossfadeLength{ getCrossfadeLength(sampleRate) };
+    auto * const fadeInGains{ mCrossfadeGains.getWritePointer(0) };
+    auto * const fadeOutGains{ mCrossfadeGains.getWritePointer(1) };
+    for (int i{}; i < numSamples; ++i) {
+        auto const progress{ std::min(1.0f,
+                                      static_cast<float>(mCrossfadePosition + i) / static_cast<float>(crossfadeLength)) };
+        auto const angle{ progress * juce::MathConstants<float>::halfPi };
+        fadeInGains[i] = std::sin(angle);
+        fadeOutGains[i] = std::cos(angle);
+    }
+
+    auto const mix = [&](float * const dest, float const * const fadingOut) {
+        juce::FloatVectorOperations::multiply(dest, fadeInGains, numSamples);
+        juce::FloatVectorOperations::addWithMultiply(dest, fadingOut, fadeOutGains, numSamples);
+    };
+    for (auto const channel : speakerBuffer) {
+        mix(channel.value->getWritePointer(0), fadingOutBuffer[channel.key].getReadPointer(0));
+    }
+    if (mAudioData.config->isStereo) {
+        for (int i{}; i < 2; ++i) {
+            mix(stereoBuffer.getWritePointer(i), mCrossfadeStereoBuffer.getReadPointer(i));
+        }
+    }
+
+    mCrossfadePosition += numSamples;
+    if (mCrossfadePosition >= crossfadeLength) {
+        endCrossfade();
+    }
+}
+
+//==============================================================================
+void AudioProcessor::ingestInputs(float const * const * inputChannelData,
+                                  int const totalNumInputChannels,
+                                  int const numInputSamples,
+                                  SourceAudioBuffer & sourceBuffer) noexcept
+{
+    auto const & sourcesAudioConfig{ mAudioData.config->sourcesAudioConfig };
+    auto const numSamples{ sourceBuffer.getNumSamples() };
+    // The device can deliver fewer samples than the buffer was prepared for : never read past its channels.
+    auto const numSamplesToCopy{ std::min(numInputSamples, numSamples) };
+    auto const numInputChannelsToCopy{ std::min(totalNumInputChannels, sourceBuffer.size()) };
+
+    if (mIngestedInputBufferGeneration != mInputBufferGeneration) {
+        // A new buffer has undefined content.
+        mDirtySources.set();
+        mIngestedInputBufferGeneration = mInputBufferGeneration;
+    }
+
+    auto activeChannel{ std::begin(sourcesAudioConfig) };
+    for (int i{}; activeChannel != std::end(sourcesAudioConfig); ++i, ++activeChannel) {
+        source_index_t const sourceIndex{ activeChannel->key };
+        auto const inputIndex{ sourceIndex.get() - source_index_t::OFFSET };
+        auto const dirtyIndex{ static_cast<size_t>(inputIndex) };
+        if (i >= numInputChannelsToCopy || inputIndex >= totalNumInputChannels
+            || sourcesAudioConfig[sourceIndex].isMuted) {
+            if (mDirtySources.test(dirtyIndex)) {
+                sourceBuffer[sourceIndex].clear();
+                mDirtySources.reset(dirtyIndex);
+            }
+            mIngestedPeaks[sourceIndex] = 0.0f;
+            continue;
+        }
+        mDirtySources.set(dirtyIndex);
+        auto * const destination{ sourceBuffer[sourceIndex].getWritePointer(0) };
+        mIngestedPeaks[sourceIndex]
+            = kernels::copyAndGetMagnitude(inputChannelData[inputIndex], destination, numSamplesToCopy);
+        if (numSamplesToCopy < numSamples) {
+            juce::FloatVectorOperations::clear(destination + numSamplesToCopy, numSamples - numSamplesToCopy);
+        }
+    }
+
+    mHasIngestedPeaks = true;
+}
+
+//==============================================================================
+void AudioProcessor::processInputPeaks(SourceAudioBuffer & inputBuffer, SourcePeaks & peaks) noexcept
+{
+    if (mHasIngestedPeaks) {
+        // ingestInputs() wrote a peak for every source, including the ones it left silent.
+        for (auto const channel : inputBuffer) {
+            peaks[channel.key] = mIngestedPeaks[channel.key];
+        }
+        mHasIngestedPeaks = false;
+        return;
+    }
+
     for (auto const channel : inputBuffer) {
         auto const & config{ mAudioData.config->sourcesAudioConfig[channel.key] };
         auto const & buffer{ *channel.value };
@@ -69,6 +425,49 @@ void AudioProcessor::processInputPeaks(SourceAudioBuffer & inputBuffer, SourcePe
     }
 }
 
+//==============================================================================
+void AudioProcessor::processSourceGates(SourceAudioBuffer & inputBuffer,
+                                        SourcePeaks const & peaks,
+                                        SourcePeaks & gatedPeaks,
+                                        double const sampleRate) noexcept
+{
+    gatedPeaks = peaks;
+
+    auto const numSamples{ inputBuffer.getNumSamples() };
+    auto const numHoldSamples{ juce::roundToInt(sampleRate * SourceGate::HOLD_SECONDS) };
+    auto const isGatingEnabled{ mIsSourceGatingEnabled.load(std::memory_order_relaxed) };
+    int numProcessedSources{};
+
+    for (auto const channel : inputBuffer) {
+        auto & gate{ mSourceGates[static_cast<size_t>(channel.key.get() - source_index_t::OFFSET)] };
+        auto const peak{ peaks[channel.key] };
+        auto const wasOpen{ gate.isOpen };
+
+        if (!isGatingEnabled || peak >= SourceGate::THRESHOLD) {
+            // Opens right away : fading in would soften the attack of whatever just started.
+            gate.numHoldSamplesLeft = numHoldSamples;
+            gate.isOpen = true;
+        } else if (wasOpen) {
+            if (gate.numHoldSamplesLeft > 0) {
+                gate.numHoldSamplesLeft -= numSamples;
+            } else {
+                // Still processed one last time, but ending on silence.
+                channel.value->applyGainRamp(0, 0, numSamples, 1.0f, 0.0f);
+                gate.isOpen = false;
+            }
+        }
+
+        if (wasOpen || gate.isOpen) {
+            ++numProcessedSources;
+        } else {
+            gatedPeaks[channel.key] = 0.0f;
+        }
+    }
+
+    mNumProcessedSources.store(numProcessedSources, std::memory_order_relaxed);
+    mNumSources.store(inputBuffer.size(), std::memory_order_relaxed);
+}
+
 //==============================================================================
 void AudioProcessor::processOutputModifiersAndPeaks(SpeakerAudioBuffer & speakersBuffer, SpeakerPeaks & peaks) noexcept
 {
@@ -84,21 +483,29 @@ void AudioProcessor::processOutputModifiersAndPeaks(SpeakerAudioBuffer & speaker
             continue;
         }
 
-        buffer.applyGain(0, numSamples, gain);
+        auto * const samples{ buffer.getWritePointer(0) };
+        if (!config.highpassConfig) {
+            peaks[channel.key] = kernels::applyGainAndGetMagnitude(samples, numSamples, gain);
+            continue;
+        }
 
-        if (config.highpassConfig) {
-            auto * const samples{ buffer.getWritePointer(0) };
-            auto const & highpassConfig{ *config.highpassConfig };
-            auto & highpassVars{ mAudioData.state.speakersAudioState[channel.key].highpassState };
-            if (highpassConfig.isNewConfig) {
-                highpassVars.resetValues();
-                highpassConfig.isNewConfig = false;
-            }
-            highpassConfig.process(samples, numSamples, highpassVars, mRandomNoise);
+        auto const & highpassConfig{ *config.highpassConfig };
+        auto & highpassVars{ mAudioData.state.speakersAudioState[channel.key].highpassState };
+        if (highpassConfig.isNewConfig) {
+            highpassVars.resetValues();
+            highpassConfig.isNewConfig = false;
         }
 
-        auto const magnitude{ buffer.getMagnitude(0, numSamples) };
-        peaks[channel.key] = magnitude;
+        // The filter is linear : running it before the gain lets the gain and the peak share a single pass. It is
+        // defined in StructGRIS and only processes one channel at a time, so it can't go into the SIMD kernel.
+        // Interleaving both over short chunks still streams the channel from memory only once.
+        auto peak{ 0.0f };
+        for (int start{}; start < numSamples; start += OUTPUT_CHUNK_SIZE) {
+            auto const chunkSize{ std::min(OUTPUT_CHUNK_SIZE, numSamples - start) };
+            highpassConfig.process(samples + start, chunkSize, highpassVars, mRandomNoise);
+            peak = std::max(peak, kernels::applyGainAndGetMagnitude(samples + start, chunkSize, gain));
+        }
+        peaks[channel.key] = peak;
     }
 }
 
@@ -108,12 +515,7 @@ void AudioProcessor::processAudio(SourceAudioBuffer & sourceBuffer,
                                   juce::AudioBuffer<float> & stereoBuffer,
                                   double sampleRate) noexcept NONBLOCKING
 {
-    // Skip if the user is editing the speaker setup.
-    juce::ScopedTryLock const lock{ mLock };
-    if (!lock.isLocked()) {
-        return;
-    }
-
+    // The algorithm and the config are both swapped in by updateAudioConfig() : nothing here needs a lock.
     if (mPulsedNoiseParams.sampleRate != sampleRate && mAudioData.config->pinkNoisePulsed) {
         mPulsedNoiseParams.sampleRate = sampleRate;
         mPulsedNoiseParams.phaseIncrement
@@ -126,7 +528,11 @@ void AudioProcessor::processAudio(SourceAudioBuffer & sourceBuffer,
     // Process source peaks
     auto * sourcePeaksTicket{ mAudioData.sourcePeaksUpdater.acquire() };
     auto & sourcePeaks{ sourcePeaksTicket->get() };
-    processInputPeaks(sourceBuffer, sourcePeaks);
+    {
+        CallbackProfiler::ScopedStage const stage{ mProfiler, CallbackProfiler::Stage::inputPeaks };
+        processInputPeaks(sourceBuffer, sourcePeaks);
+        processSourceGates(sourceBuffer, sourcePeaks, mGatedSourcePeaks, sampleRate);
+    }
 
     if (mAudioData.config->pinkNoiseGain) {
         // Process pink noise
@@ -141,17 +547,24 @@ void AudioProcessor::processAudio(SourceAudioBuffer & sourceBuffer,
                           *mAudioData.config->pinkNoiseGain,
                           mAudioData.config->pinkNoisePulsed,
                           mPulsedNoiseParams);
+        // Nothing to crossfade when the algorithms are not heard.
+        endCrossfade();
     } else {
         // Process spat algorithm
-        mSpatAlgorithm->process(*mAudioData.config, sourceBuffer, speakerBuffer, stereoBuffer, sourcePeaks, nullptr);
+        {
+            CallbackProfiler::ScopedStage const stage{ mProfiler, CallbackProfiler::Stage::spatAlgorithm };
+            processSpatAlgorithms(sourceBuffer, speakerBuffer, stereoBuffer, mGatedSourcePeaks, sampleRate);
+        }
 
         // Process direct outs
+        CallbackProfiler::ScopedStage const stage{ mProfiler, CallbackProfiler::Stage::directOuts };
         for (auto const & directOutPair : mAudioData.config->directOutPairs) {
             auto const & origin{ sourceBuffer[directOutPair.first] };
             auto & dest{ speakerBuffer[directOutPair.second] };
             dest.addFrom(0, 0, origin, 0, 0, numSamples);
         }
     }
+    processBufferFade(speakerBuffer, stereoBuffer, sampleRate);
 
     // Process peaks/gains/highpass
     mAudioData.sourcePeaksUpdater.setMostRecent(sourcePeaksTicket);
@@ -176,14 +589,25 @@ void AudioProcessor::processAudio(SourceAudioBuffer & sourceBuffer,
     auto * speakerPeaksTicket{ mAudioData.speakerPeaksUpdater.acquire() };
     auto & speakerPeaks{ speakerPeaksTicket->get() };
     // Process speaker peaks/gains/highpass
-    processOutputModifiersAndPeaks(speakerBuffer, speakerPeaks);
+    {
+        CallbackProfiler::ScopedStage const stage{ mProfiler, CallbackProfiler::Stage::outputModifiers };
+        processOutputModifiersAndPeaks(speakerBuffer, speakerPeaks);
+    }
     mAudioData.speakerPeaksUpdater.setMostRecent(speakerPeaksTicket);
 }
 
 //==============================================================================
 AudioProcessor::~AudioProcessor()
 {
-    if (auto const audioDevice{ AudioManager::getInstance().getAudioDeviceManager().getCurrentAudioDevice() })
-        audioDevice->close();
+    // There is no device when rendering offline.
+    if (AudioManager::isInitialized()) {
+        if (auto const audioDevice{ AudioManager::getInstance().getAudioDeviceManager().getCurrentAudioDevice() })
+            audioDevice->close();
+    }
+    endCrossfade();
+    if (mHeldUpdate != nullptr) {
+        mConfigUpdates.retire(mHeldUpdate);
+        mHeldUpdate = nullptr;
+    }
 }
 } // namespace gris
@@ -21,22 +21,109 @@
 
 #include "Containers/sg_TaggedAudioBuffer.hpp"
 #include "Data/sg_AudioStructs.hpp"
+#include "Data/sg_constants.hpp"
 #include "sg_AbstractSpatAlgorithm.hpp"
+#include "sg_CallbackProfiler.hpp"
+#include "sg_DropoutLedger.hpp"
 #include "sg_PinkNoiseGenerator.hpp"
+#include "sg_RealtimeExchange.hpp"
 #include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <cstdint>
 
 namespace gris
 {
 class SpeakerModel;
 
+//==============================================================================
+/** Keeps a source out of the spatialization while it is silent.
+ *
+ * The gate opens as soon as the source goes over the threshold and closes once it stayed under it for the hold time.
+ * The block where it closes is still processed, but faded out, so that the algorithms never stop mixing a source
+ * abruptly.
+ */
+struct SourceGate {
+    static constexpr auto THRESHOLD = 0.00001f; // -100 dBFS
+    static constexpr auto HOLD_SECONDS = 0.1;
+    //==============================================================================
+    bool isOpen{ true };
+    int numHoldSamplesLeft{};
+};
+
+//==============================================================================
+/** A change to the audio configuration, handed over from the message thread to the audio thread.
+ *
+ * Every member is optional : the audio thread only swaps in the ones that are set. The buffers are only rebuilt when
+ * the sources or speakers layout (or the buffer size) changes, so that the config and the channels of the buffers
+ * always match. A new spatialization algorithm always travels with the config it was built for.
+ */
+struct AudioConfigUpdate {
+    std::unique_ptr<AudioConfig> config{};
+    std::unique_ptr<SourceAudioBuffer> inputBuffer{};
+    std::unique_ptr<SpeakerAudioBuffer> outputBuffer{};
+    // Same channels as outputBuffer : the outgoing algorithm renders into it during a crossfade.
+    std::unique_ptr<SpeakerAudioBuffer> crossfadeBuffer{};
+    // Same channels as outputBuffer, but without storage of its own : the audio thread points its channels straight
+    // to the device outputs (or to the channels of outputBuffer) for the duration of a block.
+    std::unique_ptr<SpeakerAudioBuffer> deviceOutputBuffer{};
+    std::unique_ptr<AbstractSpatAlgorithm> spatAlgorithm{};
+    //==============================================================================
+    /** Takes over whatever an older update (that the audio thread never picked up) had and this one does not. */
+    void mergeOlder(AudioConfigUpdate & older) noexcept;
+};
+
 //==============================================================================
 /** Holds the spatialization algorithm instance and does most of the audio processing. */
 class AudioProcessor
 {
     AudioData mAudioData{};
-    juce::CriticalSection mLock{};
+    RealtimeExchange<AudioConfigUpdate> mConfigUpdates{};
+    // What was last published to the audio thread. Only used by the message thread.
+    juce::Array<source_index_t> mPublishedSources{};
+    juce::Array<output_patch_t> mPublishedSpeakers{};
+    int mBufferSize{};
+    // The algorithm that the next config will be published with. Only used by the message thread.
+    std::unique_ptr<AbstractSpatAlgorithm> mPendingSpatAlgorithm{};
+    // The most recent algorithm, whether it reached the audio thread yet or not. Only used by the message thread.
+    AbstractSpatAlgorithm * mLatestSpatAlgorithm{};
+    // Owned by the audio thread.
     std::unique_ptr<AbstractSpatAlgorithm> mSpatAlgorithm{};
+    std::unique_ptr<SpeakerAudioBuffer> mCrossfadeBuffer{};
+    juce::AudioBuffer<float> mCrossfadeStereoBuffer{ 2, SpeakerAudioBuffer::MAX_NUM_SAMPLES };
+    juce::AudioBuffer<float> mCrossfadeGains{ 2, SpeakerAudioBuffer::MAX_NUM_SAMPLES };
+    // Holds the outgoing algorithm until the crossfade is over.
+    AudioConfigUpdate * mFadingOutUpdate{};
+    int mCrossfadePosition{};
+    // When the buffers change along with the algorithm, the output fades out to silence, the update gets swapped in
+    // and the output fades back in.
+    enum class BufferFade { none, fadingOut, silent, fadingIn };
+    BufferFade mBufferFade{};
+    int mBufferFadePosition{};
+    // Holds an update that changes the buffers until the output faded out.
+    AudioConfigUpdate * mHeldUpdate{};
     juce::Random mRandomNoise{};
+    // Measured while copying the device inputs, so that processAudio() does not have to read the sources again.
+    SourcePeaks mIngestedPeaks{};
+    bool mHasIngestedPeaks{};
+    // Sources that might still hold samples from a previous block. Only cleared by ingestInputs() when it does not
+    // overwrite them anyway.
+    std::bitset<MAX_NUM_SOURCES> mDirtySources{};
+    // Bumped every time a new sources buffer is swapped in. A reallocated buffer can reuse the address of the
+    // previous one, so comparing pointers is not enough to tell that its content is undefined.
+    std::uint64_t mInputBufferGeneration{ 1 };
+    std::uint64_t mIngestedInputBufferGeneration{};
+    // Indexed by source index (minus the offset). Owned by the audio thread.
+    std::array<SourceGate, MAX_NUM_SOURCES> mSourceGates{};
+    // What the algorithms get : the measured peaks, minus the gated sources. The meters still get the measured ones.
+    SourcePeaks mGatedSourcePeaks{};
+    std::atomic<bool> mIsSourceGatingEnabled{ true };
+    // Sources that went through the spatialization during the last block, out of how many there were.
+    std::atomic<int> mNumProcessedSources{};
+    std::atomic<int> mNumSources{};
+    CallbackProfiler mProfiler{};
+    DropoutLedger mDropoutLedger{};
     PulsedNoiseParams mPulsedNoiseParams{};
 
 public:
@@ -46,21 +133,81 @@ public:
     SG_DELETE_COPY_AND_MOVE(AudioProcessor)
     //==============================================================================
     void setAudioConfig(std::unique_ptr<AudioConfig> newAudioConfig);
-    [[nodiscard]] juce::CriticalSection const & getLock() const noexcept { return mLock; }
+    /** Replaces the spatialization algorithm. It only reaches the audio thread with the next call to setAudioConfig(),
+     * where it gets crossfaded with the previous one if the sources and speakers did not change. If they did, the
+     * output fades out to silence and the new algorithm fades in with the new buffers. */
+    void setSpatAlgorithm(std::unique_ptr<AbstractSpatAlgorithm> spatAlgorithm);
+    /** Rebuilds both buffers for a new block size. */
+    void setBufferSize(int bufferSize);
+    /** Called by the audio thread at the start of every block : swaps in the most recent config and buffers published
+     * by the message thread. Never blocks. */
+    void updateAudioConfig(std::unique_ptr<SourceAudioBuffer> & inputBuffer,
+                           std::unique_ptr<SpeakerAudioBuffer> & outputBuffer,
+                           std::unique_ptr<SpeakerAudioBuffer> & deviceOutputBuffer) noexcept;
+    /** Audio thread : copies the device inputs into the sources buffer and measures their peaks in the same pass. The
+     * sources that are not copied (muted or without an input) are only cleared if they were written since the last
+     * time. */
+    void ingestInputs(float const * const * inputChannelData,
+                      int totalNumInputChannels,
+                      int numInputSamples,
+                      SourceAudioBuffer & sourceBuffer) noexcept;
+    /** Audio thread : the sources buffer was filled by something else than ingestInputs(). */
+    void invalidateIngestedInputs() noexcept { mIngestedInputBufferGeneration = 0; }
     void processAudio(SourceAudioBuffer & sourceBuffer,
                       SpeakerAudioBuffer & speakerBuffer,
                       juce::AudioBuffer<float> & stereoBuffer,
                       double sampleRate) noexcept;
 
+    [[nodiscard]] CallbackProfiler & getProfiler() noexcept { return mProfiler; }
+    [[nodiscard]] DropoutLedger & getDropoutLedger() noexcept { return mDropoutLedger; }
+    /** How many sources were spatialized during the last block. The others were gated because they were silent. */
+    [[nodiscard]] int getNumProcessedSources() const noexcept
+    {
+        return mNumProcessedSources.load(std::memory_order_relaxed);
+    }
+    [[nodiscard]] int getNumSources() const noexcept { return mNumSources.load(std::memory_order_relaxed); }
+    /** When disabled, every source goes through the spatialization, silent or not. Sources that were gated open
+     * right away. */
+    void setSourceGating(bool const isEnabled) noexcept
+    {
+        mIsSourceGatingEnabled.store(isEnabled, std::memory_order_relaxed);
+    }
+    [[nodiscard]] bool isSourceGatingEnabled() const noexcept
+    {
+        return mIsSourceGatingEnabled.load(std::memory_order_relaxed);
+    }
+
     auto & getAudioData() { return mAudioData; }
     auto const & getAudioData() const { return mAudioData; }
 
-    auto const & getSpatAlgorithm() const { return mSpatAlgorithm; }
-    auto & getSpatAlgorithm() { return mSpatAlgorithm; }
+    /** Message thread : the most recent algorithm set with setSpatAlgorithm(). */
+    [[nodiscard]] AbstractSpatAlgorithm * getSpatAlgorithm() const noexcept { return mLatestSpatAlgorithm; }
 
 private:
     //==============================================================================
-    void processInputPeaks(SourceAudioBuffer & inputBuffer, SourcePeaks & peaks) const noexcept;
+    void publish(std::unique_ptr<AudioConfigUpdate> update);
+    [[nodiscard]] std::unique_ptr<SourceAudioBuffer> makeInputBuffer(juce::Array<source_index_t> const & sources) const;
+    [[nodiscard]] std::unique_ptr<SpeakerAudioBuffer> makeOutputBuffer(juce::Array<output_patch_t> const & speakers) const;
+    [[nodiscard]] std::unique_ptr<SpeakerAudioBuffer>
+        makeDeviceOutputBuffer(juce::Array<output_patch_t> const & speakers, SpeakerAudioBuffer & outputBuffer) const;
+    //==============================================================================
+    void processSpatAlgorithms(SourceAudioBuffer & sourceBuffer,
+                               SpeakerAudioBuffer & speakerBuffer,
+                               juce::AudioBuffer<float> & stereoBuffer,
+                               SourcePeaks const & sourcePeaks,
+                               double sampleRate) noexcept;
+    void endCrossfade() noexcept;
+    /** Applies the fade through silence of a config update that changes the buffers, if there is one going on. */
+    void processBufferFade(SpeakerAudioBuffer & speakerBuffer,
+                           juce::AudioBuffer<float> & stereoBuffer,
+                           double sampleRate) noexcept;
+    void processInputPeaks(SourceAudioBuffer & inputBuffer, SourcePeaks & peaks) noexcept;
+    /** Copies the peaks into gatedPeaks, minus the sources that are gated : the algorithms do not pan nor mix sources
+     * without a peak. */
+    void processSourceGates(SourceAudioBuffer & inputBuffer,
+                            SourcePeaks const & peaks,
+                            SourcePeaks & gatedPeaks,
+                            double sampleRate) noexcept;
     void processOutputModifiersAndPeaks(SpeakerAudioBuffer & speakersBuffer, SpeakerPeaks & peaks) noexcept;
     //==============================================================================
     JUCE_LEAK_DETECTOR(AudioProcessor)
@@ -0,0 +1,1520 @@
+/*
+ This file is part of SpatGRIS.
+
+ Developers: Gaël Lane Lépine, Samuel Béland, Olivier Bélanger, Nicolas Masson
+
+ SpatGRIS is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ SpatGRIS is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with SpatGRIS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sg_Benchmark.hpp"
+
+#include "Data/sg_constants.hpp"
+#include "sg_AttenuationFilterBank.hpp"
+#include "sg_AudioKernels.hpp"
+#include "sg_AudioProcessor.hpp"
+#include "sg_DenseGainMatrix.hpp"
+#include "sg_OscPacketDecoder.hpp"
+#include "sg_PositionSchedule.hpp"
+#include "sg_SourcePositionJitterBuffer.hpp"
+#include "sg_SpatAlgorithmBuilder.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+namespace gris
+{
+namespace
+{
+constexpr auto BENCHMARK_OPTION = "--benchmark";
+constexpr auto SAMPLE_RATE = 48000.0;
+constexpr auto RANDOM_SEED = 2006;
+constexpr auto NUM_WARMUP_BLOCKS = 50;
+constexpr auto DEFAULT_NUM_BLOCKS = 500;
+// About one turn every 2 seconds at 512 samples per block.
+constexpr auto ROTATION_PER_BLOCK = 0.033f;
+// A VBAP triplet.
+constexpr auto MIN_SPEAKERS_PER_SOURCE = 3;
+constexpr auto GOLDEN_ANGLE = 2.3999632f;
+
+//==============================================================================
+void printUsage()
+{
+    std::cerr << "Usage : SpatGRIS --benchmark [--output <file>] [--modes vbap,mbap,hybrid,stereo]\n"
+                 "                    [--speakers 8,32,128,512] [--sources 1,16,64,256] [--buffer-sizes 64,512]\n"
+                 "                    [--blocks <count>] [--silent <percent>]\n"
+                 "                    [--mixing | --attenuation | --osc | --inputs | --handoff | --hybrid]"
+              << std::endl;
+}
+
+//==============================================================================
+juce::StringArray getListForOption(juce::ArgumentList const & args,
+                                   juce::String const & option,
+                                   juce::String const & defaultValue)
+{
+    auto const value{ args.containsOption(option) ? args.getValueForOption(option) : defaultValue };
+    auto result{ juce::StringArray::fromTokens(value, ",", "") };
+    result.trim();
+    result.removeEmptyStrings();
+    return result;
+}
+
+//==============================================================================
+juce::String kindToString(Benchmark::Kind const kind)
+{
+    switch (kind) {
+    case Benchmark::Kind::processAudio:
+        return "processAudio";
+    case Benchmark::Kind::mixing:
+        return "mixing";
+    case Benchmark::Kind::attenuation:
+        return "attenuation";
+    case Benchmark::Kind::oscDecode:
+        return "oscDecode";
+    case Benchmark::Kind::inputs:
+        return "inputs";
+    case Benchmark::Kind::handoff:
+        return "handoff";
+    case Benchmark::Kind::hybrid:
+        return "hybrid";
+    }
+    jassertfalse;
+    return "";
+}
+
+//==============================================================================
+juce::String getModeName(Benchmark::Case const & benchmarkCase)
+{
+    if (benchmarkCase.stereoMode) {
+        return "stereo";
+    }
+    switch (benchmarkCase.spatMode) {
+    case SpatMode::vbap:
+        return "vbap";
+    case SpatMode::mbap:
+        return "mbap";
+    case SpatMode::hybrid:
+        return "hybrid";
+    case SpatMode::invalid:
+        break;
+    }
+    jassertfalse;
+    return "";
+}
+
+//==============================================================================
+/** Spreads the speakers evenly over the upper hemisphere, on a dome or on the faces of a cube. */
+Position getSpeakerPosition(int const index, int const numSpeakers, bool const isCube)
+{
+    auto const z{ (static_cast<float>(index) + 0.5f) / static_cast<float>(numSpeakers) };
+    radians_t const azimuth{ GOLDEN_ANGLE * static_cast<float>(index) };
+    radians_t const elevation{ std::asin(z) };
+    Position const position{ PolarVector{ azimuth.balanced(), elevation, 1.0f } };
+    if (!isCube) {
+        return position;
+    }
+
+    auto const cartesian{ position.getCartesian() };
+    auto const scale{ 1.0f / std::max({ std::abs(cartesian.x), std::abs(cartesian.y), std::abs(cartesian.z) }) };
+    return Position{ CartesianVector{ cartesian.x * scale, cartesian.y * scale, cartesian.z * scale } };
+}
+
+//==============================================================================
+/** Sources are on a ring that slowly turns when they are moving. */
+Position getSourcePosition(int const index, int const numSources, float const rotation, SpatMode const spatMode)
+{
+    radians_t const azimuth{ juce::MathConstants<float>::twoPi * static_cast<float>(index)
+                                 / static_cast<float>(numSources)
+                             + rotation };
+    radians_t const elevation{ juce::MathConstants<float>::pi / 8.0f };
+    Position const position{ PolarVector{ azimuth.balanced(), elevation, 1.0f } };
+
+    // Same as MainContentComponent::setSourcePosition()
+    if (spatMode == SpatMode::mbap) {
+        return position.getCartesian().clampedToFarField();
+    }
+    return position.getPolar().normalized();
+}
+
+//==============================================================================
+SpatGrisData makeData(Benchmark::Case const & benchmarkCase)
+{
+    SpatGrisData data{};
+
+    auto const isCube{ benchmarkCase.spatMode == SpatMode::mbap };
+    data.speakerSetup.spatMode = isCube ? SpatMode::mbap : SpatMode::vbap;
+    for (int i{}; i < benchmarkCase.numSpeakers; ++i) {
+        output_patch_t const outputPatch{ i + 1 };
+        auto speaker{ std::make_unique<SpeakerData>() };
+        speaker->position = getSpeakerPosition(i, benchmarkCase.numSpeakers, isCube);
+        data.speakerSetup.speakers.add(outputPatch, std::move(speaker));
+        data.speakerSetup.ordering.add(outputPatch);
+    }
+
+    data.project.spatMode = benchmarkCase.spatMode;
+    data.project.useMulticoreDSP = benchmarkCase.useMulticoreDSP;
+    for (int i{}; i < benchmarkCase.numSources; ++i) {
+        source_index_t const sourceIndex{ i + 1 };
+        auto source{ std::make_unique<SourceData>() };
+        // Hybrid projects get half of each.
+        source->hybridSpatMode = i % 2 == 0 ? SpatMode::vbap : SpatMode::mbap;
+        auto const effectiveSpatMode{ benchmarkCase.spatMode == SpatMode::hybrid ? source->hybridSpatMode
+                                                                                 : benchmarkCase.spatMode };
+        source->position = getSourcePosition(i, benchmarkCase.numSources, 0.0f, effectiveSpatMode);
+        data.project.sources.add(sourceIndex, std::move(source));
+        data.project.ordering.add(sourceIndex);
+    }
+
+    data.appData.stereoMode = benchmarkCase.stereoMode;
+    data.appData.audioSettings.sampleRate = SAMPLE_RATE;
+    data.appData.audioSettings.bufferSize = benchmarkCase.bufferSize;
+
+    return data;
+}
+
+//==============================================================================
+/** Writes OSC packets field by field, malformed ones included. */
+class OscPacketWriter
+{
+    juce::MemoryOutputStream mStream{};
+
+public:
+    //==============================================================================
+    OscPacketWriter & string(char const * string)
+    {
+        auto const size{ std::strlen(string) };
+        mStream.write(string, size);
+        for (auto padding{ 4 - size % 4 }; padding > 0; --padding) {
+            mStream.writeByte(0);
+        }
+        return *this;
+    }
+    OscPacketWriter & raw(char const * data, size_t const size)
+    {
+        mStream.write(data, size);
+        return *this;
+    }
+    OscPacketWriter & int32(std::int32_t const value)
+    {
+        mStream.writeIntBigEndian(value);
+        return *this;
+    }
+    OscPacketWriter & float32(float const value)
+    {
+        mStream.writeFloatBigEndian(value);
+        return *this;
+    }
+    /** "#bundle" and a time tag that means "immediately". */
+    OscPacketWriter & bundleHeader() { return string("#bundle").int32(0).int32(1); }
+    /** A bundle element : its size, then its content. */
+    OscPacketWriter & element(juce::MemoryBlock const & packet)
+    {
+        int32(static_cast<std::int32_t>(packet.getSize()));
+        return raw(static_cast<char const *>(packet.getData()), packet.getSize());
+    }
+    [[nodiscard]] juce::MemoryBlock getPacket() const { return mStream.getMemoryBlock(); }
+};
+
+//==============================================================================
+/** A "pol" source position message, in its own packet, the way ControlGRIS sends them. */
+juce::MemoryBlock encodeSourcePositionMessage(int const sourceIndex, std::array<float, 5> const & values)
+{
+    OscPacketWriter writer{};
+    writer.string("/spat/serv").string(",sifffff").string("pol").int32(sourceIndex);
+    for (auto const value : values) {
+        writer.float32(value);
+    }
+    return writer.getPacket();
+}
+
+//==============================================================================
+/** Feeds the OscPacketDecoder with the kind of packets that a network can bring and tells which ones it handled right.
+ */
+juce::var checkOscPacketDecoder()
+{
+    OscPacketDecoder decoder{};
+    // The number of arguments of every message that got visited, or nothing if the packet was rejected.
+    auto const decode = [&](char const * data, int const size) -> tl::optional<juce::Array<int>> {
+        juce::Array<int> sizes{};
+        auto const visitor = [&](OscMessageView const & message, OscTimeTag) { sizes.add(message.size()); };
+        if (!decoder.decode(data, size, visitor)) {
+            return tl::nullopt;
+        }
+        return sizes;
+    };
+    auto const decodePacket = [&](juce::MemoryBlock const & packet) {
+        return decode(static_cast<char const *>(packet.getData()), static_cast<int>(packet.getSize()));
+    };
+
+    auto const packet{ encodeSourcePositionMessage(1, { 0.1f, 0.2f, 0.3f, 0.4f, 0.5f }) };
+    auto const * const data{ static_cast<char const *>(packet.getData()) };
+    auto const size{ static_cast<int>(packet.getSize()) };
+
+    // Cut anywhere, a packet is either rejected or loses every argument along with its type tags.
+    auto const hasArguments = [](int const numArguments) { return numArguments > 0; };
+    auto rejectsTruncatedPackets{ true };
+    for (int truncatedSize{}; truncatedSize < size; ++truncatedSize) {
+        auto const sizes{ decode(data, truncatedSize) };
+        if (sizes && std::any_of(sizes->begin(), sizes->end(), hasArguments)) {
+            rejectsTruncatedPackets = false;
+        }
+    }
+
+    // A size that is not a multiple of 4 is malformed, but the packet itself can start anywhere in memory.
+    std::vector<char> paddedData(data, data + size);
+    paddedData.resize(paddedData.size() + 4);
+    auto rejectsMisalignedPackets{ true };
+    for (int extraSize{ 1 }; extraSize < 4; ++extraSize) {
+        rejectsMisalignedPackets = rejectsMisalignedPackets && !decode(paddedData.data(), size + extraSize);
+    }
+    std::vector<char> shiftedData(static_cast<size_t>(size) + 1);
+    std::memcpy(shiftedData.data() + 1, data, static_cast<size_t>(size));
+    auto shiftedValue{ 0.0f };
+    decoder.decode(shiftedData.data() + 1, size, [&](OscMessageView const & message, OscTimeTag) {
+        shiftedValue = message[2].getFloat32();
+    });
+    auto const readsUnalignedPackets{ juce::approximatelyEqual(shiftedValue, 0.1f) };
+
+    juce::Array<juce::MemoryBlock> corruptPackets{};
+    // A blob that claims to be bigger than the packet.
+    corruptPackets.add(
+        OscPacketWriter{}.string("/spat/serv").string(",sb").string("pol").int32(0x7FFFFFFF).int32(0).getPacket());
+    // A type that does not exist.
+    corruptPackets.add(OscPacketWriter{}.string("/spat/serv").string(",sx").string("pol").int32(0).getPacket());
+    // Type tags without a terminator.
+    corruptPackets.add(OscPacketWriter{}.string("/spat/serv").raw(",iii", 4).getPacket());
+    // Bundle elements bigger than the bundle, or with a negative size.
+    corruptPackets.add(OscPacketWriter{}.bundleHeader().int32(1024).element(packet).getPacket());
+    corruptPackets.add(OscPacketWriter{}.bundleHeader().int32(-4).element(packet).getPacket());
+    // Bundles nested deeper than the decoder allows.
+    auto nestedBundles{ packet };
+    for (int depth{}; depth < 32; ++depth) {
+        nestedBundles = OscPacketWriter{}.bundleHeader().element(nestedBundles).getPacket();
+    }
+    corruptPackets.add(nestedBundles);
+    auto const rejectsCorruptPackets{ std::none_of(
+        corruptPackets.begin(),
+        corruptPackets.end(),
+        [&](juce::MemoryBlock const & corruptPacket) { return decodePacket(corruptPacket).has_value(); }) };
+
+    // The legacy positions can leave out the gain, their last argument : OscInput has to make do with 6 of them.
+    OscPacketWriter legacyWriter{};
+    legacyWriter.string("/spat/serv").string(",ifffff").int32(0);
+    for (auto const value : { 0.1f, 0.2f, 0.3f, 0.4f, 0.5f }) {
+        legacyWriter.float32(value);
+    }
+    auto const legacySizes{ decodePacket(legacyWriter.getPacket()) };
+    auto const readsLegacyPacketsWithoutGain{ legacySizes && *legacySizes == juce::Array<int>{ 6 } };
+
+    auto * checks{ new juce::DynamicObject{} };
+    checks->setProperty("rejectsTruncatedPackets", rejectsTruncatedPackets);
+    checks->setProperty("rejectsMisalignedPackets", rejectsMisalignedPackets);
+    checks->setProperty("readsUnalignedPackets", readsUnalignedPackets);
+    checks->setProperty("rejectsCorruptPackets", rejectsCorruptPackets);
+    checks->setProperty("readsLegacyPacketsWithoutGain", readsLegacyPacketsWithoutGain);
+    return juce::var{ checks };
+}
+
+//==============================================================================
+/** Goes through what OscInput and the spat data updater expect from the PositionSchedule and OscTimeTag, and tells
+ * which ones hold.
+ */
+juce::var checkPositionSchedule()
+{
+    // The first coordinate tells the events apart.
+    auto const makeEvent = [](juce::int64 const timeMs, int const sourceIndex, float const id) {
+        SourcePositionMailboxes::Message message{};
+        message.coordinates[0] = id;
+        return PositionSchedule::Event{ timeMs, source_index_t{ sourceIndex }, message };
+    };
+    auto const releaseIds = [](PositionSchedule & schedule, juce::int64 const timeMs) {
+        juce::Array<float> ids{};
+        auto const nextTimeMs{ schedule.releaseDue(timeMs, [&](PositionSchedule::Event const & event) {
+            ids.add(event.message.coordinates[0]);
+        }) };
+        return std::make_pair(ids, nextTimeMs);
+    };
+
+    // By time, then in the order they were scheduled.
+    auto releasesInOrder{ true };
+    {
+        PositionSchedule schedule{};
+        for (auto const & event : { makeEvent(30, 1, 1.0f),
+                                    makeEvent(10, 2, 2.0f),
+                                    makeEvent(20, 3, 3.0f),
+                                    makeEvent(10, 4, 4.0f) }) {
+            releasesInOrder = schedule.schedule(event) && releasesInOrder;
+        }
+        auto const first{ releaseIds(schedule, 25) };
+        auto const second{ releaseIds(schedule, 30) };
+        releasesInOrder = releasesInOrder && first.first == juce::Array<float>{ 2.0f, 4.0f, 3.0f }
+                          && first.second == tl::optional<juce::int64>{ 30 }
+                          && second.first == juce::Array<float>{ 1.0f } && !second.second;
+    }
+
+    // Only the events scheduled before the discard are dropped, and only for that source.
+    auto discardsOnlyOlderEvents{ false };
+    {
+        PositionSchedule schedule{};
+        auto isScheduled{ schedule.schedule(makeEvent(10, 1, 1.0f)) };
+        isScheduled = schedule.schedule(makeEvent(10, 2, 2.0f)) && isScheduled;
+        schedule.discard(source_index_t{ 1 });
+        isScheduled = schedule.schedule(makeEvent(20, 1, 3.0f)) && isScheduled;
+        discardsOnlyOlderEvents = isScheduled && releaseIds(schedule, 100).first == juce::Array<float>{ 2.0f, 3.0f };
+    }
+
+    // NTP counts from 1900, the host clock from 1970. Half a second is half of the 32 bits fraction.
+    static constexpr std::uint64_t NTP_TO_UNIX_EPOCH_SECONDS = 2208988800;
+    static constexpr std::uint64_t UNIX_SECONDS = 1700000000;
+    OscTimeTag const timeTag{ ((UNIX_SECONDS + NTP_TO_UNIX_EPOCH_SECONDS) << 32) | 0x80000000u };
+    auto const convertsTimeTags{ !timeTag.isImmediate()
+                                 && timeTag.toMilliseconds() == static_cast<juce::int64>(UNIX_SECONDS) * 1000 + 500
+                                 && OscTimeTag{}.isImmediate() };
+
+    auto const nowMs{ juce::Time::currentTimeMillis() };
+    auto const rejectsFarAheadTimes{ PositionSchedule::isWithinHorizon(nowMs + PositionSchedule::MAX_AHEAD_MS, nowMs)
+                                     && !PositionSchedule::isWithinHorizon(nowMs + PositionSchedule::MAX_AHEAD_MS + 1,
+                                                                           nowMs) };
+
+    auto * checks{ new juce::DynamicObject{} };
+    checks->setProperty("releasesInOrder", releasesInOrder);
+    checks->setProperty("discardsOnlyOlderEvents", discardsOnlyOlderEvents);
+    checks->setProperty("convertsTimeTags", convertsTimeTags);
+    checks->setProperty("rejectsFarAheadTimes", rejectsFarAheadTimes);
+    return juce::var{ checks };
+}
+
+//==============================================================================
+/** Plays a few movements through the SourcePositionJitterBuffer and tells which ones come out the way they should. */
+juce::var checkSourcePositionJitterBuffer()
+{
+    using Kind = SourcePositionMailboxes::Kind;
+    using Message = SourcePositionMailboxes::Message;
+    static constexpr auto DELAY_MS = 100;
+    static constexpr auto PROCESS_INTERVAL_MS = 5;
+    source_index_t const sourceIndex{ 1 };
+
+    // Too big for the stack.
+    auto const makeBuffer = [] {
+        auto buffer{ std::make_unique<SourcePositionJitterBuffer>() };
+        buffer->setDelayMs(DELAY_MS);
+        return buffer;
+    };
+    auto const play = [&](SourcePositionJitterBuffer & buffer,
+                          std::vector<std::pair<double, Message>> const & arrivals,
+                          double const endTimeMs) {
+        std::vector<Message> outputs{};
+        auto nextArrival{ arrivals.cbegin() };
+        for (double timeMs{}; timeMs <= endTimeMs; timeMs += PROCESS_INTERVAL_MS) {
+            for (; nextArrival != arrivals.cend() && nextArrival->first <= timeMs; ++nextArrival) {
+                [[maybe_unused]] auto const isPushed{
+                    buffer.push(sourceIndex, nextArrival->second, nextArrival->first)
+                };
+                jassert(isPushed);
+            }
+            buffer.process(timeMs, [&](source_index_t, Message const & message) { outputs.push_back(message); });
+        }
+        return outputs;
+    };
+    auto const legacy = [](float const azimuth) { return Message{ Kind::legacy, { azimuth, 0.0f, 1.0f }, 0.0f, 0.0f }; };
+
+    // A message every 10 ms moves the azimuth by 0.01, but four of them arrive together after a gap : that jump of 0.04
+    // has to be spread over several steps. Past the last position, the source overshoots a little and comes back.
+    auto spreadsBursts{ false };
+    {
+        std::vector<std::pair<double, Message>> arrivals{};
+        for (auto i{ 0 }; i < 16; ++i) {
+            auto const arrivalMs{ i >= 6 && i < 10 ? 90.0 : 10.0 * i };
+            arrivals.emplace_back(arrivalMs, legacy(0.01f * static_cast<float>(i)));
+        }
+        auto const buffer{ makeBuffer() };
+        auto const outputs{ play(*buffer, arrivals, 600.0) };
+        auto largestStep{ 0.0f };
+        for (size_t i{ 1 }; i < outputs.size(); ++i) {
+            largestStep = std::max(largestStep, std::abs(outputs[i].coordinates[0] - outputs[i - 1].coordinates[0]));
+        }
+        spreadsBursts = !outputs.empty() && largestStep < 0.02f
+                        && juce::approximatelyEqual(outputs.back().coordinates[0], 0.15f);
+    }
+
+    // From 350 to 10 degrees, the short way : through 0, never anywhere near 180, even when overshooting.
+    auto wrapsAroundAzimuth{ false };
+    {
+        auto const buffer{ makeBuffer() };
+        auto const outputs{ play(*buffer,
+                                 { { 0.0, legacy(juce::degreesToRadians(350.0f)) },
+                                   { 20.0, legacy(juce::degreesToRadians(10.0f)) } },
+                                 400.0) };
+        wrapsAroundAzimuth = outputs.size() > 2;
+        for (auto const & output : outputs) {
+            auto const azimuth{ std::remainder(output.coordinates[0], juce::MathConstants<float>::twoPi) };
+            wrapsAroundAzimuth = wrapsAroundAzimuth && std::abs(azimuth) < juce::degreesToRadians(45.0f);
+        }
+    }
+
+    // A cartesian source turning by 179 degrees on the unit sphere stays on it instead of going through the center.
+    auto keepsRadiusOnLongTurns{ false };
+    {
+        auto const angle{ juce::degreesToRadians(179.0f) };
+        Message const from{ Kind::cartesian, { 1.0f, 0.0f, 0.0f }, 0.0f, 0.0f };
+        Message const to{ Kind::cartesian, { std::cos(angle), std::sin(angle), 0.0f }, 0.0f, 0.0f };
+        auto const buffer{ makeBuffer() };
+        auto const outputs{ play(*buffer, { { 0.0, from }, { 20.0, to } }, 400.0) };
+        keepsRadiusOnLongTurns = outputs.size() > 2;
+        for (auto const & output : outputs) {
+            auto const radius{ std::hypot(output.coordinates[0], output.coordinates[1], output.coordinates[2]) };
+            keepsRadiusOnLongTurns = keepsRadiusOnLongTurns && std::abs(radius - 1.0f) < 1e-3f;
+        }
+    }
+
+    // Once disabled, the buffer hands out the last position right away and has nothing left to do.
+    auto flushesWhenDisabled{ false };
+    {
+        auto const buffer{ makeBuffer() };
+        auto isPushed{ buffer->push(sourceIndex, legacy(0.1f), 0.0) };
+        isPushed = buffer->push(sourceIndex, legacy(0.2f), 0.0) && isPushed;
+        tl::optional<Message> output{};
+        buffer->setDelayMs(0);
+        auto const hasWorkLeft{ buffer->process(0.0, [&](source_index_t, Message const & message) {
+            output = message;
+        }) };
+        flushesWhenDisabled = isPushed && !hasWorkLeft && output
+                              && juce::approximatelyEqual(output->coordinates[0], 0.2f);
+    }
+
+    // A discarded source does not move anymore.
+    auto discardsPositions{ false };
+    {
+        auto const buffer{ makeBuffer() };
+        auto const isPushed{ buffer->push(sourceIndex, legacy(0.1f), 0.0) };
+        buffer->discard(sourceIndex);
+        auto hasOutput{ false };
+        auto const hasWorkLeft{ buffer->process(1000.0, [&](source_index_t, Message const &) { hasOutput = true; }) };
+        discardsPositions = isPushed && !hasWorkLeft && !hasOutput;
+    }
+
+    auto * checks{ new juce::DynamicObject{} };
+    checks->setProperty("spreadsBursts", spreadsBursts);
+    checks->setProperty("wrapsAroundAzimuth", wrapsAroundAzimuth);
+    checks->setProperty("keepsRadiusOnLongTurns", keepsRadiusOnLongTurns);
+    checks->setProperty("flushesWhenDisabled", flushesWhenDisabled);
+    checks->setProperty("discardsPositions", discardsPositions);
+    return juce::var{ checks };
+}
+
+//==============================================================================
+double ticksToNs(double const ticks)
+{
+    return ticks * 1e9 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+}
+
+//==============================================================================
+/** The gains from every source to the few speakers that it actually reaches, for the --mixing case.
+ *
+ * VBAP only feeds the speakers of one triplet (a few more with some span), so at hundreds of speakers a dense
+ * sources x speakers mix mostly multiplies by zero. Each source keeps a list of (speaker, gain, target gain) entries
+ * instead, and mixing only touches those. An entry is dropped once its gain ramped down to zero. All the memory is
+ * allocated by the constructor.
+ */
+class SparseGainMatrix
+{
+    struct Entry {
+        int speaker{};
+        float gain{};
+        float targetGain{};
+    };
+
+    int mNumSpeakers{};
+    std::vector<std::vector<Entry>> mEntries{};
+    // Speakers that already have an entry. Only used by setTargetGains().
+    std::vector<bool> mHasEntry{};
+
+public:
+    //==============================================================================
+    SparseGainMatrix(int const numSources, int const numSpeakers)
+        : mNumSpeakers(numSpeakers)
+        , mEntries(static_cast<size_t>(numSources))
+        , mHasEntry(static_cast<size_t>(numSpeakers))
+    {
+        // A source can reach every speaker : that way, push_back() never allocates.
+        for (auto & entries : mEntries) {
+            entries.reserve(static_cast<size_t>(numSpeakers));
+        }
+    }
+    //==============================================================================
+    /** Sets the gains that a source ramps to during the next mix(). There must be one gain per speaker. */
+    void setTargetGains(int const source, float const * const gains) noexcept
+    {
+        auto & entries{ mEntries[static_cast<size_t>(source)] };
+
+        // The speakers that the source already reaches keep their current gain and ramp from there...
+        for (auto & entry : entries) {
+            entry.targetGain = gains[entry.speaker];
+            mHasEntry[static_cast<size_t>(entry.speaker)] = true;
+        }
+        // ...while the new ones start from silence.
+        for (int speaker{}; speaker < mNumSpeakers; ++speaker) {
+            if (!mHasEntry[static_cast<size_t>(speaker)] && gains[speaker] >= SMALL_GAIN) {
+                entries.push_back(Entry{ speaker, 0.0f, gains[speaker] });
+            }
+        }
+        for (auto const & entry : entries) {
+            mHasEntry[static_cast<size_t>(entry.speaker)] = false;
+        }
+    }
+    //==============================================================================
+    /** Adds the source to every speaker that it reaches, ramping the gains to their targets over the block. */
+    void mix(int const source, float const * const input, float * const * const speakers, int const numSamples) noexcept
+    {
+        auto & entries{ mEntries[static_cast<size_t>(source)] };
+        for (auto & entry : entries) {
+            kernels::addWithGainRamp(input, speakers[entry.speaker], numSamples, entry.gain, entry.targetGain);
+            entry.gain = entry.targetGain;
+        }
+        entries.erase(std::remove_if(entries.begin(),
+                                     entries.end(),
+                                     [](Entry const & entry) { return entry.gain < SMALL_GAIN; }),
+                      entries.end());
+    }
+};
+
+//==============================================================================
+/** A worker that gets one job per block, for the --handoff case. It either spins on the job (like the multicore
+ * preset B) or sleeps on an event until it gets one (like the preset A). A job does nothing : only the time that the
+ * worker takes to pick it up is measured.
+ */
+class HandoffWorker
+{
+public:
+    enum class Policy { spin, sleep };
+
+private:
+    Policy mPolicy{};
+    // When the job was posted, or 0 if there is none.
+    std::atomic<juce::int64> mPostedTicks{};
+    std::atomic<juce::int64> mLatencyTicks{};
+    std::atomic<bool> mShouldExit{};
+    juce::WaitableEvent mJobEvent{};
+    std::thread mThread{};
+
+public:
+    //==============================================================================
+    explicit HandoffWorker(Policy const policy) : mPolicy(policy), mThread([this]() { run(); }) {}
+    ~HandoffWorker()
+    {
+        mShouldExit.store(true);
+        mJobEvent.signal();
+        mThread.join();
+    }
+    SG_DELETE_COPY_AND_MOVE(HandoffWorker)
+    //==============================================================================
+    /** Posts a job and spins until the worker picked it up. Returns how many ticks that took. */
+    juce::int64 handOff() noexcept
+    {
+        mLatencyTicks.store(-1);
+        mPostedTicks.store(juce::Time::getHighResolutionTicks());
+        if (mPolicy == Policy::sleep) {
+            mJobEvent.signal();
+        }
+        auto latencyTicks{ mLatencyTicks.load() };
+        while (latencyTicks < 0) {
+            latencyTicks = mLatencyTicks.load();
+        }
+        return latencyTicks;
+    }
+
+private:
+    //==============================================================================
+    void run() noexcept
+    {
+        while (!mShouldExit.load()) {
+            auto const postedTicks{ mPostedTicks.exchange(0) };
+            if (postedTicks != 0) {
+                mLatencyTicks.store(juce::Time::getHighResolutionTicks() - postedTicks);
+            } else if (mPolicy == Policy::sleep) {
+                // A job posted since the exchange left the event signaled : this returns right away.
+                mJobEvent.wait(-1);
+            }
+        }
+    }
+};
+
+} // namespace
+
+//==============================================================================
+Benchmark::Benchmark(Kind const kind, juce::Array<Case> cases, int const numBlocks, juce::File outputFile)
+    : mKind(kind)
+    , mCases(std::move(cases))
+    , mNumBlocks(numBlocks)
+    , mOutputFile(std::move(outputFile))
+{
+}
+
+//==============================================================================
+int Benchmark::run() const
+{
+    JUCE_ASSERT_MESSAGE_THREAD;
+
+    juce::Array<juce::var> results{};
+    for (int i{}; i < mCases.size(); ++i) {
+        auto const & benchmarkCase{ mCases.getReference(i) };
+        std::cerr << "[" << i + 1 << "/" << mCases.size() << "] "
+                  << (mKind == Kind::processAudio ? getModeName(benchmarkCase) : kindToString(mKind)) << ", "
+                  << benchmarkCase.numSpeakers << " speakers, " << benchmarkCase.numSources << " sources, "
+                  << benchmarkCase.bufferSize << " samples" << (benchmarkCase.useMulticoreDSP ? ", multicore" : "")
+                  << (benchmarkCase.sourcesAreMoving ? ", moving" : "") << std::endl;
+        switch (mKind) {
+        case Kind::processAudio:
+            results.add(runCase(benchmarkCase));
+            break;
+        case Kind::mixing:
+            results.add(runMixingCase(benchmarkCase));
+            break;
+        case Kind::attenuation:
+            results.add(runAttenuationCase(benchmarkCase));
+            break;
+        case Kind::oscDecode:
+            results.add(runOscDecodeCase(benchmarkCase));
+            break;
+        case Kind::inputs:
+            results.add(runInputsCase(benchmarkCase));
+            break;
+        case Kind::handoff:
+            results.add(runHandoffCase(benchmarkCase));
+            break;
+        case Kind::hybrid:
+            results.add(runHybridCase(benchmarkCase));
+            break;
+        }
+    }
+
+    auto * report{ new juce::DynamicObject{} };
+    report->setProperty("kind", kindToString(mKind));
+    report->setProperty("version", ProjectInfo::versionString);
+#if JUCE_DEBUG
+    report->setProperty("build", "debug");
+#else
+    report->setProperty("build", "release");
+#endif
+    report->setProperty("cpu", juce::SystemStats::getCpuModel());
+    report->setProperty("numCpus", juce::SystemStats::getNumCpus());
+    report->setProperty("os", juce::SystemStats::getOperatingSystemName());
+    report->setProperty("date", juce::Time::getCurrentTime().toISO8601(true));
+    report->setProperty("sampleRate", SAMPLE_RATE);
+    report->setProperty("numBlocks", mNumBlocks);
+    report->setProperty("results", results);
+
+    auto const json{ juce::JSON::toString(juce::var{ report }) };
+    if (mOutputFile == juce::File{}) {
+        std::cout << json << std::endl;
+        return EXIT_SUCCESS;
+    }
+    if (!mOutputFile.replaceWithText(json)) {
+        std::cerr << "Error : unable to write to \"" << mOutputFile.getFullPathName() << "\"." << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+//==============================================================================
+bool Benchmark::isBenchmarkCommandLine(juce::String const & commandLine)
+{
+    return juce::StringArray::fromTokens(commandLine, true).contains(BENCHMARK_OPTION);
+}
+
+//==============================================================================
+std::unique_ptr<Benchmark> Benchmark::fromCommandLine(juce::String const & commandLine)
+{
+    juce::ArgumentList const args{ "SpatGRIS", commandLine };
+    jassert(args.containsOption(BENCHMARK_OPTION));
+
+    auto const numBlocks{ args.containsOption("--blocks") ? args.getValueForOption("--blocks").getIntValue()
+                                                          : DEFAULT_NUM_BLOCKS };
+    juce::File outputFile{};
+    if (args.containsOption("--output")) {
+        outputFile = juce::File::getCurrentWorkingDirectory().getChildFile(
+            args.getValueForOption("--output").unquoted());
+    }
+    auto const silentPercent{ args.containsOption("--silent") ? args.getValueForOption("--silent").getIntValue() : 0 };
+    if (numBlocks <= 0 || silentPercent < 0 || silentPercent > 100) {
+        printUsage();
+        return nullptr;
+    }
+
+    juce::Array<int> speakerCounts{};
+    juce::Array<int> sourceCounts{};
+    juce::Array<int> bufferSizes{};
+    for (auto const & value : getListForOption(args, "--speakers", "8,32,128,512")) {
+        speakerCounts.add(value.getIntValue());
+    }
+    for (auto const & value : getListForOption(args, "--sources", "1,16,64,256")) {
+        sourceCounts.add(value.getIntValue());
+    }
+    for (auto const & value : getListForOption(args, "--buffer-sizes", "64,512")) {
+        bufferSizes.add(value.getIntValue());
+    }
+    auto const isPositive = [](int const value) { return value > 0; };
+    auto const isValidBufferSize = [](int const value) {
+        return value > 0 && value <= SpeakerAudioBuffer::MAX_NUM_SAMPLES;
+    };
+    if (speakerCounts.isEmpty() || sourceCounts.isEmpty() || bufferSizes.isEmpty()
+        || !std::all_of(speakerCounts.begin(), speakerCounts.end(), isPositive)
+        || !std::all_of(sourceCounts.begin(), sourceCounts.end(), isPositive)
+        || !std::all_of(bufferSizes.begin(), bufferSizes.end(), isValidBufferSize)) {
+        printUsage();
+        return nullptr;
+    }
+
+    juce::Array<Case> cases{};
+    if (args.containsOption("--mixing")) {
+        // The mixing does not depend on the mode nor on the positions.
+        for (auto const numSpeakers : speakerCounts) {
+            for (auto const numSources : sourceCounts) {
+                for (auto const bufferSize : bufferSizes) {
+                    Case benchmarkCase{};
+                    benchmarkCase.spatMode = SpatMode::vbap;
+                    benchmarkCase.numSpeakers = numSpeakers;
+                    benchmarkCase.numSources = numSources;
+                    benchmarkCase.bufferSize = bufferSize;
+                    cases.add(benchmarkCase);
+                }
+            }
+        }
+        return std::make_unique<Benchmark>(Kind::mixing, std::move(cases), numBlocks, outputFile);
+    }
+    if (args.containsOption("--attenuation")) {
+        // Only the sources are attenuated.
+        for (auto const numSources : sourceCounts) {
+            for (auto const bufferSize : bufferSizes) {
+                Case benchmarkCase{};
+                benchmarkCase.spatMode = SpatMode::mbap;
+                benchmarkCase.numSources = numSources;
+                benchmarkCase.bufferSize = bufferSize;
+                benchmarkCase.sourcesAreMoving = true;
+                cases.add(benchmarkCase);
+            }
+        }
+        return std::make_unique<Benchmark>(Kind::attenuation, std::move(cases), numBlocks, outputFile);
+    }
+    if (args.containsOption("--osc")) {
+        // Only the number of sources matters : a frame is one message per source.
+        for (auto const numSources : sourceCounts) {
+            Case benchmarkCase{};
+            benchmarkCase.spatMode = SpatMode::vbap;
+            benchmarkCase.numSources = numSources;
+            benchmarkCase.sourcesAreMoving = true;
+            cases.add(benchmarkCase);
+        }
+        return std::make_unique<Benchmark>(Kind::oscDecode, std::move(cases), numBlocks, outputFile);
+    }
+    if (args.containsOption("--inputs")) {
+        // Only the sources are copied.
+        for (auto const numSources : sourceCounts) {
+            for (auto const bufferSize : bufferSizes) {
+                Case benchmarkCase{};
+                benchmarkCase.spatMode = SpatMode::vbap;
+                benchmarkCase.numSources = numSources;
+                benchmarkCase.bufferSize = bufferSize;
+                benchmarkCase.numSilentSources = numSources * silentPercent / 100;
+                cases.add(benchmarkCase);
+            }
+        }
+        return std::make_unique<Benchmark>(Kind::inputs, std::move(cases), numBlocks, outputFile);
+    }
+    if (args.containsOption("--handoff")) {
+        // The buffer size sets the time between two jobs. The load is either nothing or every core kept busy.
+        for (auto const bufferSize : bufferSizes) {
+            for (auto const numLoadThreads : { 0, juce::SystemStats::getNumCpus() }) {
+                Case benchmarkCase{};
+                benchmarkCase.spatMode = SpatMode::vbap;
+                benchmarkCase.bufferSize = bufferSize;
+                benchmarkCase.numLoadThreads = numLoadThreads;
+                cases.add(benchmarkCase);
+            }
+        }
+        return std::make_unique<Benchmark>(Kind::handoff, std::move(cases), numBlocks, outputFile);
+    }
+    if (args.containsOption("--hybrid")) {
+        // Every case runs on a single core and then in parallel.
+        for (auto const numSpeakers : speakerCounts) {
+            for (auto const numSources : sourceCounts) {
+                for (auto const bufferSize : bufferSizes) {
+                    Case benchmarkCase{};
+                    benchmarkCase.spatMode = SpatMode::hybrid;
+                    benchmarkCase.numSpeakers = numSpeakers;
+                    benchmarkCase.numSources = numSources;
+                    benchmarkCase.bufferSize = bufferSize;
+                    benchmarkCase.numSilentSources = numSources * silentPercent / 100;
+                    cases.add(benchmarkCase);
+                }
+            }
+        }
+        return std::make_unique<Benchmark>(Kind::hybrid, std::move(cases), numBlocks, outputFile);
+    }
+
+    for (auto const & mode : getListForOption(args, "--modes", "vbap,mbap,hybrid,stereo")) {
+        Case baseCase{};
+        if (mode == "vbap") {
+            baseCase.spatMode = SpatMode::vbap;
+        } else if (mode == "mbap") {
+            baseCase.spatMode = SpatMode::mbap;
+        } else if (mode == "hybrid") {
+            baseCase.spatMode = SpatMode::hybrid;
+        } else if (mode == "stereo") {
+            baseCase.spatMode = SpatMode::vbap;
+            baseCase.stereoMode = StereoMode::stereo;
+        } else {
+            printUsage();
+            return nullptr;
+        }
+
+        // Same restriction as SpatAlgorithmBuilder::build()
+        auto const supportsMulticoreDSP{ !baseCase.stereoMode };
+
+        for (auto const numSpeakers : speakerCounts) {
+            for (auto const numSources : sourceCounts) {
+                for (auto const bufferSize : bufferSizes) {
+                    for (auto const useMulticoreDSP : { false, true }) {
+                        if (useMulticoreDSP && !supportsMulticoreDSP) {
+                            continue;
+                        }
+                        for (auto const sourcesAreMoving : { false, true }) {
+                            auto benchmarkCase{ baseCase };
+                            benchmarkCase.numSpeakers = numSpeakers;
+                            benchmarkCase.numSources = numSources;
+                            benchmarkCase.bufferSize = bufferSize;
+                            benchmarkCase.useMulticoreDSP = useMulticoreDSP;
+                            benchmarkCase.sourcesAreMoving = sourcesAreMoving;
+                            benchmarkCase.numSilentSources = numSources * silentPercent / 100;
+                            cases.add(benchmarkCase);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return std::make_unique<Benchmark>(Kind::processAudio, std::move(cases), numBlocks, outputFile);
+}
+
+//==============================================================================
+juce::var Benchmark::runCase(Case const & benchmarkCase) const
+{
+    auto * result{ new juce::DynamicObject{} };
+    juce::var const resultVar{ result };
+    result->setProperty("mode", getModeName(benchmarkCase));
+    result->setProperty("numSpeakers", benchmarkCase.numSpeakers);
+    result->setProperty("numSources", benchmarkCase.numSources);
+    result->setProperty("bufferSize", benchmarkCase.bufferSize);
+    result->setProperty("multicore", benchmarkCase.useMulticoreDSP);
+    result->setProperty("moving", benchmarkCase.sourcesAreMoving);
+    result->setProperty("numSilentSources", benchmarkCase.numSilentSources);
+
+    auto data{ makeData(benchmarkCase) };
+    auto spatAlgorithm{ SpatAlgorithmBuilder::build({ data.speakerSetup,
+                                                      data.project.spatMode,
+                                                      data.appData.stereoMode,
+                                                      data.project.sources,
+                                                      SAMPLE_RATE,
+                                                      benchmarkCase.bufferSize,
+                                                      benchmarkCase.useMulticoreDSP }) };
+    if (!spatAlgorithm || spatAlgorithm->getError()) {
+        result->setProperty("error", "unable to build the spatialization algorithm for this layout");
+        return resultVar;
+    }
+    for (auto const source : data.project.sources) {
+        spatAlgorithm->updateSpatData(source.key, *source.value);
+    }
+
+    // Same sequence as the audio device callback.
+    AudioProcessor audioProcessor{};
+    audioProcessor.setBufferSize(benchmarkCase.bufferSize);
+    audioProcessor.setSpatAlgorithm(std::move(spatAlgorithm));
+    audioProcessor.setAudioConfig(data.toAudioConfig());
+    std::unique_ptr<SourceAudioBuffer> inputBuffer{};
+    std::unique_ptr<SpeakerAudioBuffer> outputBuffer{};
+    // Only used to render straight into the outputs of an audio device.
+    std::unique_ptr<SpeakerAudioBuffer> deviceOutputBuffer{};
+    audioProcessor.updateAudioConfig(inputBuffer, outputBuffer, deviceOutputBuffer);
+    jassert(inputBuffer && outputBuffer);
+    auto & algorithm{ *audioProcessor.getSpatAlgorithm() };
+    audioProcessor.getProfiler().startBlock(benchmarkCase.bufferSize, SAMPLE_RATE);
+    juce::AudioBuffer<float> stereoBuffer{ 2, benchmarkCase.bufferSize };
+
+    juce::Random random{ RANDOM_SEED };
+    std::vector<float> noise(static_cast<size_t>(benchmarkCase.bufferSize));
+    std::generate(noise.begin(), noise.end(), [&]() { return random.nextFloat() * 2.0f - 1.0f; });
+
+    std::vector<juce::int64> blockTicks{};
+    blockTicks.reserve(static_cast<size_t>(mNumBlocks));
+    juce::int64 totalUpdateTicks{};
+    juce::int64 totalProcessedSources{};
+    auto rotation{ 0.0f };
+
+    for (int block{}; block < NUM_WARMUP_BLOCKS + mNumBlocks; ++block) {
+        auto const isMeasured{ block >= NUM_WARMUP_BLOCKS };
+
+        if (benchmarkCase.sourcesAreMoving) {
+            // This happens on the OSC thread in the app : it is measured apart from the audio processing.
+            auto const updateStart{ juce::Time::getHighResolutionTicks() };
+            rotation += ROTATION_PER_BLOCK;
+            int sourceNumber{};
+            for (auto const source : data.project.sources) {
+                auto const effectiveSpatMode{ data.project.spatMode == SpatMode::hybrid ? source.value->hybridSpatMode
+                                                                                        : data.project.spatMode };
+                source.value->position
+                    = getSourcePosition(sourceNumber++, benchmarkCase.numSources, rotation, effectiveSpatMode);
+                algorithm.updateSpatData(source.key, *source.value);
+            }
+            if (isMeasured) {
+                totalUpdateTicks += juce::Time::getHighResolutionTicks() - updateStart;
+            }
+        }
+
+        // The last sources of the ring play silence. The warmup blocks are longer than the gates hold time.
+        int sourceNumber{};
+        for (auto const source : data.project.sources) {
+            auto * const samples{ (*inputBuffer)[source.key].getWritePointer(0) };
+            if (sourceNumber++ < benchmarkCase.numSources - benchmarkCase.numSilentSources) {
+                std::copy(noise.cbegin(), noise.cend(), samples);
+            } else {
+                std::fill(samples, samples + benchmarkCase.bufferSize, 0.0f);
+            }
+        }
+        outputBuffer->silence();
+        stereoBuffer.clear();
+
+        auto const start{ juce::Time::getHighResolutionTicks() };
+        audioProcessor.processAudio(*inputBuffer, *outputBuffer, stereoBuffer, SAMPLE_RATE);
+        auto const ticks{ juce::Time::getHighResolutionTicks() - start };
+        if (isMeasured) {
+            blockTicks.push_back(ticks);
+            totalProcessedSources += audioProcessor.getNumProcessedSources();
+        }
+    }
+
+    std::sort(blockTicks.begin(), blockTicks.end());
+    auto const totalTicks{ std::accumulate(blockTicks.cbegin(), blockTicks.cend(), juce::int64{}) };
+    auto const meanNs{ ticksToNs(static_cast<double>(totalTicks) / static_cast<double>(blockTicks.size())) };
+    auto const percentileNs = [&](double const ratio) {
+        auto const index{ std::min(blockTicks.size() - 1,
+                                   static_cast<size_t>(ratio * static_cast<double>(blockTicks.size()))) };
+        return ticksToNs(static_cast<double>(blockTicks[index]));
+    };
+    auto const numOutputs{ benchmarkCase.stereoMode ? 2 : benchmarkCase.numSpeakers };
+    auto const numPairSamples{ static_cast<double>(benchmarkCase.bufferSize) * benchmarkCase.numSources * numOutputs };
+    auto const deadlineNs{ 1e9 * benchmarkCase.bufferSize / SAMPLE_RATE };
+
+    result->setProperty("meanBlockNs", meanNs);
+    result->setProperty("medianBlockNs", percentileNs(0.5));
+    result->setProperty("p99BlockNs", percentileNs(0.99));
+    result->setProperty("maxBlockNs", ticksToNs(static_cast<double>(blockTicks.back())));
+    result->setProperty("nsPerSamplePerPair", meanNs / numPairSamples);
+    result->setProperty("deadlineLoad", meanNs / deadlineNs);
+    result->setProperty("meanProcessedSources",
+                        static_cast<double>(totalProcessedSources) / static_cast<double>(mNumBlocks));
+    if (benchmarkCase.sourcesAreMoving) {
+        result->setProperty("meanSpatDataUpdateNs",
+                            ticksToNs(static_cast<double>(totalUpdateTicks) / static_cast<double>(mNumBlocks)));
+    }
+
+    return resultVar;
+}
+
+//==============================================================================
+juce::var Benchmark::runMixingCase(Case const & benchmarkCase) const
+{
+    auto * result{ new juce::DynamicObject{} };
+    juce::var const resultVar{ result };
+    result->setProperty("numSpeakers", benchmarkCase.numSpeakers);
+    result->setProperty("numSources", benchmarkCase.numSources);
+    result->setProperty("bufferSize", benchmarkCase.bufferSize);
+
+    auto const numSpeakers{ static_cast<size_t>(benchmarkCase.numSpeakers) };
+    auto const numSources{ static_cast<size_t>(benchmarkCase.numSources) };
+    auto const bufferSize{ static_cast<size_t>(benchmarkCase.bufferSize) };
+
+    juce::Random random{ RANDOM_SEED };
+    std::vector<std::vector<float>> inputs(numSources, std::vector<float>(bufferSize));
+    for (auto & input : inputs) {
+        std::generate(input.begin(), input.end(), [&]() { return random.nextFloat() * 2.0f - 1.0f; });
+    }
+    std::vector<float const *> sourcePointers{};
+    for (auto const & input : inputs) {
+        sourcePointers.push_back(input.data());
+    }
+    std::vector<std::vector<float>> outputs(numSpeakers, std::vector<float>(bufferSize));
+    std::vector<float *> outputPointers{};
+    for (auto & output : outputs) {
+        outputPointers.push_back(output.data());
+    }
+
+    // Both mixes run the same blocks, so that neither of them benefits from a warmer cache.
+    auto const measure = [&](auto && mixBlock) {
+        juce::int64 totalTicks{};
+        for (int block{}; block < NUM_WARMUP_BLOCKS + mNumBlocks; ++block) {
+            for (auto & output : outputs) {
+                std::fill(output.begin(), output.end(), 0.0f);
+            }
+            auto const start{ juce::Time::getHighResolutionTicks() };
+            mixBlock();
+            if (block >= NUM_WARMUP_BLOCKS) {
+                totalTicks += juce::Time::getHighResolutionTicks() - start;
+            }
+        }
+        return ticksToNs(static_cast<double>(totalTicks) / static_cast<double>(mNumBlocks));
+    };
+
+    juce::Array<juce::var> densities{};
+    juce::var crossover{};
+    auto speakersPerSource{ std::min(MIN_SPEAKERS_PER_SOURCE, benchmarkCase.numSpeakers) };
+    while (true) {
+        // Each source reaches a run of neighbouring speakers, starting somewhere else for every source.
+        std::vector<std::vector<float>> gains(numSources, std::vector<float>(numSpeakers));
+        DenseGainMatrix denseGains{ benchmarkCase.numSources, benchmarkCase.numSpeakers, benchmarkCase.bufferSize };
+        SparseGainMatrix sparseGains{ benchmarkCase.numSources, benchmarkCase.numSpeakers };
+        for (size_t source{}; source < numSources; ++source) {
+            for (int i{}; i < speakersPerSource; ++i) {
+                auto const speaker{ (source * 7 + static_cast<size_t>(i)) % numSpeakers };
+                gains[source][speaker] = 1.0f / static_cast<float>(speakersPerSource);
+            }
+            denseGains.setTargetGains(static_cast<int>(source), gains[source].data());
+            sparseGains.setTargetGains(static_cast<int>(source), gains[source].data());
+        }
+
+        auto const denseNs{ measure([&]() {
+            for (size_t source{}; source < numSources; ++source) {
+                for (size_t speaker{}; speaker < numSpeakers; ++speaker) {
+                    auto const gain{ gains[source][speaker] };
+                    kernels::addWithGainRamp(inputs[source].data(),
+                                             outputPointers[speaker],
+                                             benchmarkCase.bufferSize,
+                                             gain,
+                                             gain);
+                }
+            }
+        }) };
+        auto const blockedDenseNs{ measure([&]() {
+            denseGains.mix(sourcePointers.data(), outputPointers.data(), benchmarkCase.bufferSize);
+        }) };
+        auto const sparseNs{ measure([&]() {
+            for (size_t source{}; source < numSources; ++source) {
+                sparseGains.mix(static_cast<int>(source),
+                                inputs[source].data(),
+                                outputPointers.data(),
+                                benchmarkCase.bufferSize);
+            }
+        }) };
+
+        auto * density{ new juce::DynamicObject{} };
+        density->setProperty("speakersPerSource", speakersPerSource);
+        density->setProperty("denseBlockNs", denseNs);
+        density->setProperty("blockedDenseBlockNs", blockedDenseNs);
+        density->setProperty("sparseBlockNs", sparseNs);
+        densities.add(juce::var{ density });
+        if (crossover.isVoid() && sparseNs >= std::min(denseNs, blockedDenseNs)) {
+            crossover = speakersPerSource;
+        }
+
+        if (speakersPerSource >= benchmarkCase.numSpeakers) {
+            break;
+        }
+        speakersPerSource = std::min(speakersPerSource * 2, benchmarkCase.numSpeakers);
+    }
+
+    result->setProperty("densities", densities);
+    // The smallest number of speakers per source for which one of the dense mixes is at least as fast, if any.
+    result->setProperty("crossoverSpeakersPerSource", crossover);
+
+    return resultVar;
+}
+
+//==============================================================================
+juce::var Benchmark::runAttenuationCase(Case const & benchmarkCase) const
+{
+    auto * result{ new juce::DynamicObject{} };
+    juce::var const resultVar{ result };
+    result->setProperty("numSources", benchmarkCase.numSources);
+    result->setProperty("bufferSize", benchmarkCase.bufferSize);
+
+    auto const numSources{ static_cast<size_t>(benchmarkCase.numSources) };
+    auto const bufferSize{ static_cast<size_t>(benchmarkCase.bufferSize) };
+
+    juce::Random random{ RANDOM_SEED };
+    std::vector<float> noise(bufferSize);
+    std::generate(noise.begin(), noise.end(), [&]() { return random.nextFloat() * 2.0f - 1.0f; });
+    std::vector<std::vector<float>> buffers(numSources, std::vector<float>(bufferSize));
+    std::vector<float *> bufferPointers{};
+    for (auto & buffer : buffers) {
+        bufferPointers.push_back(buffer.data());
+    }
+
+    // Every source goes somewhere else on every block, as if they were all far away and moving.
+    std::vector<std::vector<std::pair<float, float>>> targets(static_cast<size_t>(NUM_WARMUP_BLOCKS + mNumBlocks),
+                                                              std::vector<std::pair<float, float>>(numSources));
+    for (auto & blockTargets : targets) {
+        for (auto & [gain, coefficient] : blockTargets) {
+            gain = random.nextFloat();
+            coefficient = AttenuationFilterBank::getCoefficient(125.0f + random.nextFloat() * 7875.0f, SAMPLE_RATE);
+        }
+    }
+
+    // Both run the same blocks, so that neither of them benefits from a warmer cache.
+    auto const measure = [&](auto && processBlock) {
+        juce::int64 totalTicks{};
+        for (int block{}; block < NUM_WARMUP_BLOCKS + mNumBlocks; ++block) {
+            for (auto & buffer : buffers) {
+                std::copy(noise.cbegin(), noise.cend(), buffer.begin());
+            }
+            auto const start{ juce::Time::getHighResolutionTicks() };
+            processBlock(targets[static_cast<size_t>(block)]);
+            if (block >= NUM_WARMUP_BLOCKS) {
+                totalTicks += juce::Time::getHighResolutionTicks() - start;
+            }
+        }
+        return ticksToNs(static_cast<double>(totalTicks) / static_cast<double>(mNumBlocks));
+    };
+
+    // The same filters, one source after the other.
+    struct SourceState {
+        float gain{ 1.0f };
+        float coefficient{};
+        float lastOutput{};
+    };
+    std::vector<SourceState> states(numSources);
+    auto const perSourceNs{ measure([&](std::vector<std::pair<float, float>> const & blockTargets) {
+        auto const inverseNumSamples{ 1.0f / static_cast<float>(bufferSize) };
+        for (size_t source{}; source < numSources; ++source) {
+            auto & state{ states[source] };
+            auto const [targetGain, targetCoefficient]{ blockTargets[source] };
+            auto const gainIncrement{ (targetGain - state.gain) * inverseNumSamples };
+            auto const coefficientIncrement{ (targetCoefficient - state.coefficient) * inverseNumSamples };
+            auto * const samples{ bufferPointers[source] };
+            for (size_t i{}; i < bufferSize; ++i) {
+                state.lastOutput = samples[i] * (1.0f - state.coefficient) + state.lastOutput * state.coefficient;
+                samples[i] = state.lastOutput * state.gain;
+                state.gain += gainIncrement;
+                state.coefficient += coefficientIncrement;
+            }
+            state.gain = targetGain;
+            state.coefficient = targetCoefficient;
+        }
+    }) };
+    // Both start from the same state and go through the same blocks : their last blocks have to match.
+    auto const perSourceBuffers{ buffers };
+
+    AttenuationFilterBank filterBank{ benchmarkCase.numSources };
+    auto const filterBankNs{ measure([&](std::vector<std::pair<float, float>> const & blockTargets) {
+        for (size_t source{}; source < numSources; ++source) {
+            filterBank.setTarget(static_cast<int>(source), blockTargets[source].first, blockTargets[source].second);
+        }
+        filterBank.process(bufferPointers.data(), benchmarkCase.bufferSize);
+    }) };
+
+    auto maxDifference{ 0.0f };
+    for (size_t source{}; source < numSources; ++source) {
+        for (size_t i{}; i < bufferSize; ++i) {
+            maxDifference = std::max(maxDifference, std::abs(buffers[source][i] - perSourceBuffers[source][i]));
+        }
+    }
+
+    result->setProperty("perSourceBlockNs", perSourceNs);
+    result->setProperty("filterBankBlockNs", filterBankNs);
+    // Only rounding errors are expected : the ramps are not accumulated in the same order.
+    result->setProperty("maxDifference", maxDifference);
+    result->setProperty("outputsMatch", maxDifference < 1e-4f);
+
+    return resultVar;
+}
+
+//==============================================================================
+juce::var Benchmark::runOscDecodeCase(Case const & benchmarkCase) const
+{
+    auto * result{ new juce::DynamicObject{} };
+    juce::var const resultVar{ result };
+    result->setProperty("numSources", benchmarkCase.numSources);
+
+    // A few frames of a controller moving every source, cycled through on every block.
+    static constexpr int NUM_FRAMES = 16;
+    juce::Random random{ RANDOM_SEED };
+    std::vector<int> sourceIndices{};
+    std::vector<std::array<float, 5>> values{};
+    std::vector<juce::MemoryBlock> packets{};
+    for (int frame{}; frame < NUM_FRAMES; ++frame) {
+        for (int source{}; source < benchmarkCase.numSources; ++source) {
+            std::array<float, 5> const messageValues{ random.nextFloat() * juce::MathConstants<float>::twoPi,
+                                                      random.nextFloat() * juce::MathConstants<float>::halfPi,
+                                                      random.nextFloat(),
+                                                      random.nextFloat(),
+                                                      random.nextFloat() };
+            sourceIndices.push_back(source + 1);
+            values.push_back(messageValues);
+            packets.push_back(encodeSourcePositionMessage(source + 1, messageValues));
+        }
+    }
+
+    // Both decode the same messages and sum what they read, which also tells if they agree.
+    auto const measure = [&](auto && decodeMessage) {
+        juce::int64 totalTicks{};
+        float checksum{};
+        for (int block{}; block < NUM_WARMUP_BLOCKS + mNumBlocks; ++block) {
+            checksum = 0.0f;
+            auto const start{ juce::Time::getHighResolutionTicks() };
+            for (size_t i{}; i < packets.size(); ++i) {
+                checksum += decodeMessage(i);
+            }
+            if (block >= NUM_WARMUP_BLOCKS) {
+                totalTicks += juce::Time::getHighResolutionTicks() - start;
+            }
+        }
+        auto const numMessages{ static_cast<double>(mNumBlocks) * static_cast<double>(packets.size()) };
+        return std::make_pair(ticksToNs(static_cast<double>(totalTicks) / numMessages), checksum);
+    };
+
+    // What every message used to go through : the juce::OSCMessage built by juce::OSCReceiver, its formatting for the
+    // OSC monitor, whether it was open or not, and the juce::String comparisons of OscInput::getMessageType().
+    juce::String const spatGrisAddress{ "/spat/serv" };
+    auto const juceResult{ measure([&](size_t const index) {
+        auto const & messageValues{ values[index] };
+        juce::OSCMessage const message{ juce::OSCAddressPattern{ spatGrisAddress },
+                                        juce::String{ "pol" },
+                                        static_cast<juce::int32>(sourceIndices[index]),
+                                        messageValues[0],
+                                        messageValues[1],
+                                        messageValues[2],
+                                        messageValues[3],
+                                        messageValues[4] };
+
+        auto text{ juce::String{ "[" } + message.getAddressPattern().toString() + "] " };
+        for (auto const & argument : message) {
+            text += juce::String{ ", " }
+                    + (argument.isFloat32() ? juce::String{ argument.getFloat32() }
+                       : argument.isInt32() ? juce::String{ argument.getInt32() }
+                                            : argument.getString());
+        }
+
+        if (message.getAddressPattern().toString() != spatGrisAddress || message[0].getString() != "pol"
+            || text.isEmpty()) {
+            return 0.0f;
+        }
+        return message[2].getFloat32();
+    }) };
+
+    OscPacketDecoder decoder{};
+    auto const decoderResult{ measure([&](size_t const index) {
+        auto const & packet{ packets[index] };
+        auto value{ 0.0f };
+        decoder.decode(static_cast<char const *>(packet.getData()),
+                       static_cast<int>(packet.getSize()),
+                       [&](OscMessageView const & message, OscTimeTag) {
+                           if (message.getAddressHash() == hashOscString("/spat/serv") && message.size() == 7
+                               && hashOscString(message[0].getString()) == hashOscString("pol")) {
+                               value = message[2].getFloat32();
+                           }
+                       });
+        return value;
+    }) };
+
+    result->setProperty("juceMessageNs", juceResult.first);
+    result->setProperty("decoderMessageNs", decoderResult.first);
+    result->setProperty("juceMessagesPerSecond", 1e9 / juceResult.first);
+    result->setProperty("decoderMessagesPerSecond", 1e9 / decoderResult.first);
+    result->setProperty("decodedValuesMatch", juce::approximatelyEqual(juceResult.second, decoderResult.second));
+    result->setProperty("decoderChecks", checkOscPacketDecoder());
+    result->setProperty("scheduleChecks", checkPositionSchedule());
+    result->setProperty("jitterBufferChecks", checkSourcePositionJitterBuffer());
+
+    return resultVar;
+}
+
+//==============================================================================
+juce::var Benchmark::runInputsCase(Case const & benchmarkCase) const
+{
+    auto * result{ new juce::DynamicObject{} };
+    juce::var const resultVar{ result };
+    result->setProperty("numSources", benchmarkCase.numSources);
+    result->setProperty("bufferSize", benchmarkCase.bufferSize);
+    result->setProperty("numSilentSources", benchmarkCase.numSilentSources);
+
+    auto data{ makeData(benchmarkCase) };
+    AudioProcessor audioProcessor{};
+    audioProcessor.setBufferSize(benchmarkCase.bufferSize);
+    audioProcessor.setAudioConfig(data.toAudioConfig());
+    std::unique_ptr<SourceAudioBuffer> inputBuffer{};
+    std::unique_ptr<SpeakerAudioBuffer> outputBuffer{};
+    std::unique_ptr<SpeakerAudioBuffer> deviceOutputBuffer{};
+    audioProcessor.updateAudioConfig(inputBuffer, outputBuffer, deviceOutputBuffer);
+    jassert(inputBuffer);
+
+    // The last sources have no device input.
+    auto const numDeviceInputs{ benchmarkCase.numSources - benchmarkCase.numSilentSources };
+    juce::Random random{ RANDOM_SEED };
+    std::vector<std::vector<float>> deviceInputs(static_cast<size_t>(numDeviceInputs),
+                                                 std::vector<float>(static_cast<size_t>(benchmarkCase.bufferSize)));
+    for (auto & deviceInput : deviceInputs) {
+        std::generate(deviceInput.begin(), deviceInput.end(), [&]() { return random.nextFloat() * 2.0f - 1.0f; });
+    }
+    std::vector<float const *> deviceInputPointers{};
+    for (auto const & deviceInput : deviceInputs) {
+        deviceInputPointers.push_back(deviceInput.data());
+    }
+
+    // Also returns the sum of the peaks of the sources once it is done, which tells if both copied the same thing.
+    auto const measure = [&](auto && copyBlock) {
+        juce::int64 totalTicks{};
+        for (int block{}; block < NUM_WARMUP_BLOCKS + mNumBlocks; ++block) {
+            auto const start{ juce::Time::getHighResolutionTicks() };
+            copyBlock();
+            if (block >= NUM_WARMUP_BLOCKS) {
+                totalTicks += juce::Time::getHighResolutionTicks() - start;
+            }
+        }
+        auto checksum{ 0.0f };
+        for (auto const source : data.project.sources) {
+            checksum += (*inputBuffer)[source.key].getMagnitude(0, benchmarkCase.bufferSize);
+        }
+        return std::make_pair(ticksToNs(static_cast<double>(totalTicks) / static_cast<double>(mNumBlocks)), checksum);
+    };
+
+    // What the callback used to do : clear every source, copy the inputs over them, then read them again for the
+    // peaks.
+    std::vector<float> peaks(static_cast<size_t>(benchmarkCase.numSources));
+    auto const clearAndCopyResult{ measure([&]() {
+        inputBuffer->silence();
+        for (int i{}; i < numDeviceInputs; ++i) {
+            std::copy_n(deviceInputPointers[static_cast<size_t>(i)],
+                        benchmarkCase.bufferSize,
+                        (*inputBuffer)[source_index_t{ i + source_index_t::OFFSET }].getWritePointer(0));
+        }
+        for (auto const source : data.project.sources) {
+            peaks[static_cast<size_t>(source.key.get() - source_index_t::OFFSET)]
+                = (*inputBuffer)[source.key].getMagnitude(0, benchmarkCase.bufferSize);
+        }
+    }) };
+
+    audioProcessor.invalidateIngestedInputs();
+    auto const ingestResult{ measure([&]() {
+        audioProcessor.ingestInputs(deviceInputPointers.data(),
+                                    numDeviceInputs,
+                                    benchmarkCase.bufferSize,
+                                    *inputBuffer);
+    }) };
+
+    result->setProperty("clearAndCopyBlockNs", clearAndCopyResult.first);
+    result->setProperty("ingestBlockNs", ingestResult.first);
+    result->setProperty("sourcesMatch", juce::approximatelyEqual(clearAndCopyResult.second, ingestResult.second));
+
+    return resultVar;
+}
+
+//==============================================================================
+juce::var Benchmark::runHandoffCase(Case const & benchmarkCase) const
+{
+    auto * result{ new juce::DynamicObject{} };
+    juce::var const resultVar{ result };
+    result->setProperty("bufferSize", benchmarkCase.bufferSize);
+    result->setProperty("numLoadThreads", benchmarkCase.numLoadThreads);
+
+    // Busy threads that compete with the worker for the cores, like a loaded machine would.
+    std::atomic<bool> shouldStopLoad{};
+    std::vector<std::thread> loadThreads{};
+    for (int i{}; i < benchmarkCase.numLoadThreads; ++i) {
+        loadThreads.emplace_back([&]() {
+            auto value{ 1.0 };
+            while (!shouldStopLoad.load(std::memory_order_relaxed)) {
+                value = std::sqrt(value + 1.0);
+            }
+            juce::ignoreUnused(value);
+        });
+    }
+
+    // Posts one job per block, at the pace of an audio device.
+    auto const blockDuration{ std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>{ benchmarkCase.bufferSize / SAMPLE_RATE }) };
+    auto const measure = [&](HandoffWorker::Policy const policy, juce::String const & name) {
+        HandoffWorker worker{ policy };
+        std::vector<juce::int64> latencyTicks{};
+        latencyTicks.reserve(static_cast<size_t>(mNumBlocks));
+        auto nextBlock{ std::chrono::steady_clock::now() };
+        for (int block{}; block < NUM_WARMUP_BLOCKS + mNumBlocks; ++block) {
+            nextBlock += blockDuration;
+            std::this_thread::sleep_until(nextBlock);
+            auto const ticks{ worker.handOff() };
+            if (block >= NUM_WARMUP_BLOCKS) {
+                latencyTicks.push_back(ticks);
+            }
+        }
+        std::sort(latencyTicks.begin(), latencyTicks.end());
+        auto const percentileNs = [&](double const ratio) {
+            auto const index{ std::min(latencyTicks.size() - 1,
+                                       static_cast<size_t>(ratio * static_cast<double>(latencyTicks.size()))) };
+            return ticksToNs(static_cast<double>(latencyTicks[index]));
+        };
+        result->setProperty(name + "MedianNs", percentileNs(0.5));
+        result->setProperty(name + "P99Ns", percentileNs(0.99));
+        result->setProperty(name + "MaxNs", ticksToNs(static_cast<double>(latencyTicks.back())));
+    };
+    measure(HandoffWorker::Policy::spin, "spin");
+    measure(HandoffWorker::Policy::sleep, "sleep");
+
+    shouldStopLoad.store(true);
+    for (auto & loadThread : loadThreads) {
+        loadThread.join();
+    }
+
+    return resultVar;
+}
+
+//==============================================================================
+juce::var Benchmark::runHybridCase(Case const & benchmarkCase) const
+{
+    auto * result{ new juce::DynamicObject{} };
+    juce::var const resultVar{ result };
+    result->setProperty("numSpeakers", benchmarkCase.numSpeakers);
+    result->setProperty("numSources", benchmarkCase.numSources);
+    result->setProperty("bufferSize", benchmarkCase.bufferSize);
+    result->setProperty("numSilentSources", benchmarkCase.numSilentSources);
+
+    // The builder picks the regular hybrid algorithm without multicore DSP, and the parallel one with it.
+    auto singleCoreCase{ benchmarkCase };
+    singleCoreCase.useMulticoreDSP = false;
+    auto parallelCase{ benchmarkCase };
+    parallelCase.useMulticoreDSP = true;
+    auto const singleCore{ runCase(singleCoreCase) };
+    auto const parallel{ runCase(parallelCase) };
+    if (singleCore.hasProperty("error") || parallel.hasProperty("error")) {
+        result->setProperty("error", "unable to build the spatialization algorithm for this layout");
+        return resultVar;
+    }
+
+    auto const singleCoreMeanNs{ static_cast<double>(singleCore["meanBlockNs"]) };
+    auto const parallelMeanNs{ static_cast<double>(parallel["meanBlockNs"]) };
+    result->setProperty("singleCoreMeanBlockNs", singleCoreMeanNs);
+    result->setProperty("singleCoreP99BlockNs", singleCore["p99BlockNs"]);
+    result->setProperty("parallelMeanBlockNs", parallelMeanNs);
+    result->setProperty("parallelP99BlockNs", parallel["p99BlockNs"]);
+    result->setProperty("speedup", singleCoreMeanNs / parallelMeanNs);
+    result->setProperty("numCpus", juce::SystemStats::getNumCpus());
+
+    return resultVar;
+}
+
+} // namespace gris
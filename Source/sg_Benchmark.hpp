@@ -0,0 +1,123 @@
+/*
+ This file is part of SpatGRIS.
+
+ Developers: Gaël Lane Lépine, Samuel Béland, Olivier Bélanger, Nicolas Masson
+
+ SpatGRIS is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ SpatGRIS is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with SpatGRIS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Data/sg_LogicStrucs.hpp"
+#include "Data/sg_Macros.hpp"
+
+#include <JuceHeader.h>
+
+namespace gris
+{
+//==============================================================================
+/** Measures AudioProcessor::processAudio() over a matrix of synthetic setups and prints the results as JSON.
+ *
+ * Started from the command line with :
+ *
+ *   SpatGRIS --benchmark [--output <file>] [--modes vbap,mbap,hybrid,stereo] [--speakers 8,32,128,512]
+ *                        [--sources 1,16,64,256] [--buffer-sizes 64,512] [--blocks <count>]
+ *                        [--silent <percent>]
+ *                        [--mixing | --attenuation | --osc | --inputs | --handoff | --hybrid]
+ *
+ * Every run is seeded the same way so that two builds can be compared. Each case runs with static and moving sources,
+ * and with and without multicore DSP when the mode supports it. With --silent, that share of the sources only plays
+ * digital silence.
+ *
+ * With --mixing, only the mixing of the sources into the speakers is measured instead : dense (every source times
+ * every speaker, pair by pair or with DenseGainMatrix) against sparse (a list of the speakers that each source
+ * reaches), for a growing number of speakers reached by each source. The report tells from how many speakers per
+ * source a dense mix becomes the fastest. Neither is used by the algorithms yet.
+ *
+ * With --attenuation, only the distance attenuation of the sources is measured : one source after the other against
+ * the AttenuationFilterBank, with every source moving on every block. Both outputs are also compared, which checks
+ * the SIMD filters against the scalar ones.
+ *
+ * With --osc, only the decoding of the source position messages is measured, on a single core : the juce::OSCMessage
+ * that every message used to go through against the OscPacketDecoder. The decoder is also fed truncated, misaligned
+ * and corrupt packets, which it has to reject, and legacy positions without their gain, which it has to read. The
+ * PositionSchedule is checked as well : the order of the events, their discarding, the conversion of the time tags and
+ * the rejection of the ones too far ahead. So is the SourcePositionJitterBuffer, with a burst, an azimuth that wraps
+ * around, a half turn on the sphere, a flush and a discard.
+ *
+ * With --inputs, only the copy of the device inputs into the sources is measured : clearing every source and copying
+ * them, then measuring their peaks, the way the callback used to, against AudioProcessor::ingestInputs(). With
+ * --silent, that share of the sources has no device input.
+ *
+ * With --handoff, only the time that a worker thread takes to pick up a job posted once per block is measured : a
+ * worker that spins (the multicore preset B) against one that sleeps on an event (the preset A), on an idle machine
+ * and with as many busy threads as there are cores. This is the latency that MulticoreDSPTuner trades for idle CPU
+ * when it switches to B under load.
+ *
+ * With --hybrid, only the hybrid mode is measured : the regular algorithm on a single core against the
+ * ParallelHybridSpatAlgorithm, which renders the MBAP sources on a second core. The report tells the speedup of the
+ * parallel one, which can only be above 1 on a machine with more than one core.
+ */
+class Benchmark
+{
+public:
+    enum class Kind { processAudio, mixing, attenuation, oscDecode, inputs, handoff, hybrid };
+
+    struct Case {
+        SpatMode spatMode{};
+        tl::optional<StereoMode> stereoMode{};
+        int numSpeakers{};
+        int numSources{};
+        int bufferSize{};
+        bool useMulticoreDSP{};
+        bool sourcesAreMoving{};
+        int numSilentSources{};
+        // Busy threads that run along with the --handoff case.
+        int numLoadThreads{};
+    };
+
+private:
+    Kind mKind{};
+    juce::Array<Case> mCases{};
+    int mNumBlocks{};
+    juce::File mOutputFile{};
+
+public:
+    //==============================================================================
+    Benchmark(Kind kind, juce::Array<Case> cases, int numBlocks, juce::File outputFile);
+    Benchmark() = delete;
+    ~Benchmark() = default;
+    SG_DELETE_COPY_AND_MOVE(Benchmark)
+    //==============================================================================
+    /** Runs every case and writes the report. Returns the process exit code. */
+    [[nodiscard]] int run() const;
+    //==============================================================================
+    [[nodiscard]] static bool isBenchmarkCommandLine(juce::String const & commandLine);
+    /** Returns nullptr and prints the usage if the arguments are invalid. */
+    [[nodiscard]] static std::unique_ptr<Benchmark> fromCommandLine(juce::String const & commandLine);
+
+private:
+    //==============================================================================
+    [[nodiscard]] juce::var runCase(Case const & benchmarkCase) const;
+    [[nodiscard]] juce::var runMixingCase(Case const & benchmarkCase) const;
+    [[nodiscard]] juce::var runAttenuationCase(Case const & benchmarkCase) const;
+    [[nodiscard]] juce::var runOscDecodeCase(Case const & benchmarkCase) const;
+    [[nodiscard]] juce::var runInputsCase(Case const & benchmarkCase) const;
+    [[nodiscard]] juce::var runHandoffCase(Case const & benchmarkCase) const;
+    [[nodiscard]] juce::var runHybridCase(Case const & benchmarkCase) const;
+    //==============================================================================
+    JUCE_LEAK_DETECTOR(Benchmark)
+};
+
+} // namespace gris
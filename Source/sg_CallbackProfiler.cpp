@@ -0,0 +1,126 @@
+/*
+ This file is part of SpatGRIS.
+
+ Developers: Gaël Lane Lépine, Samuel Béland, Olivier Bélanger, Nicolas Masson
+
+ SpatGRIS is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ SpatGRIS is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with SpatGRIS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sg_CallbackProfiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace gris
+{
+//==============================================================================
+void CallbackProfiler::startBlock(int const numSamples, double const sampleRate) noexcept
+{
+    jassert(sampleRate > 0.0);
+    auto const blockDuration{ static_cast<double>(numSamples) / sampleRate };
+    mDeadlineTicks = std::max(1.0, static_cast<double>(juce::Time::secondsToHighResolutionTicks(blockDuration)));
+}
+
+//==============================================================================
+float CallbackProfiler::record(Stage const stage, juce::int64 const ticks) noexcept
+{
+    auto const stageIndex{ static_cast<size_t>(stage) };
+    auto const fraction{ static_cast<float>(static_cast<double>(ticks) / mDeadlineTicks) };
+
+    // There is only one writer, so there is no need for a read-modify-write.
+    auto const bin{ std::min(NUM_BINS - 1, static_cast<int>(fraction * 100.0f)) };
+    auto & count{ mHistograms[stageIndex][static_cast<size_t>(bin)] };
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    // ...but the max is also reset by the message thread.
+    auto & max{ mMax[stageIndex] };
+    auto currentMax{ max.load(std::memory_order_relaxed) };
+    while (fraction > currentMax && !max.compare_exchange_weak(currentMax, fraction, std::memory_order_relaxed)) {
+    }
+
+    return fraction;
+}
+
+//==============================================================================
+CallbackProfiler::Stats CallbackProfiler::collectStats()
+{
+    JUCE_ASSERT_MESSAGE_THREAD;
+
+    Stats result{};
+
+    for (size_t stageIndex{}; stageIndex < NUM_STAGES; ++stageIndex) {
+        std::array<juce::uint32, NUM_BINS> counts{};
+        juce::uint32 numBlocks{};
+        for (size_t bin{}; bin < counts.size(); ++bin) {
+            auto const total{ mHistograms[stageIndex][bin].load(std::memory_order_relaxed) };
+            // Unsigned subtraction also holds when the counter wraps around.
+            counts[bin] = total - mLastCounts[stageIndex][bin];
+            mLastCounts[stageIndex][bin] = total;
+            numBlocks += counts[bin];
+        }
+
+        auto & stats{ result[stageIndex] };
+        stats.numBlocks = static_cast<int>(numBlocks);
+        stats.max = mMax[stageIndex].exchange(0.0f, std::memory_order_relaxed);
+        if (numBlocks == 0) {
+            continue;
+        }
+
+        // Reports the upper edge of the bin where the percentile falls.
+        auto const percentile = [&](double const ratio) {
+            auto const target{ static_cast<juce::uint32>(std::ceil(ratio * static_cast<double>(numBlocks))) };
+            juce::uint32 cumulated{};
+            for (size_t bin{}; bin < counts.size(); ++bin) {
+                cumulated += counts[bin];
+                if (cumulated >= target) {
+                    return static_cast<float>(bin + 1) / 100.0f;
+                }
+            }
+            return static_cast<float>(NUM_BINS) / 100.0f;
+        };
+        stats.p50 = percentile(0.5);
+        stats.p99 = percentile(0.99);
+    }
+
+    return result;
+}
+
+//==============================================================================
+juce::String CallbackProfiler::stageToString(Stage const stage)
+{
+    switch (stage) {
+    case Stage::inputCopy:
+        return "Input copy";
+    case Stage::inputPeaks:
+        return "Input peaks";
+    case Stage::spatAlgorithm:
+        return "Spatialization";
+    case Stage::directOuts:
+        return "Direct outs";
+    case Stage::outputModifiers:
+        return "Output gains/highpass/peaks";
+    case Stage::outputCopy:
+        return "Output copy";
+    case Stage::recorders:
+        return "Recording";
+    case Stage::total:
+        return "Total";
+    case Stage::count:
+        break;
+    }
+    jassertfalse;
+    return "";
+}
+
+} // namespace gris
@@ -0,0 +1,112 @@
+/*
+ This file is part of SpatGRIS.
+
+ Developers: Gaël Lane Lépine, Samuel Béland, Olivier Bélanger, Nicolas Masson
+
+ SpatGRIS is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ SpatGRIS is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with SpatGRIS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Data/sg_Macros.hpp"
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+namespace gris
+{
+//==============================================================================
+/** Times every stage of the audio callback and keeps a histogram of each one, relative to the block deadline.
+ *
+ * The audio thread only ever increments relaxed atomics. The message thread periodically calls collectStats(), which
+ * returns the percentiles of everything that was recorded since its previous call.
+ */
+class CallbackProfiler
+{
+public:
+    enum class Stage {
+        inputCopy,
+        inputPeaks,
+        spatAlgorithm,
+        directOuts,
+        outputModifiers,
+        outputCopy,
+        recorders,
+        total,
+        count
+    };
+    static constexpr auto NUM_STAGES = static_cast<size_t>(Stage::count);
+
+    /** Durations are fractions of the block deadline : 1.0 means the stage alone took the whole block. */
+    struct StageStats {
+        float p50{};
+        float p99{};
+        float max{};
+        int numBlocks{};
+    };
+    using Stats = std::array<StageStats, NUM_STAGES>;
+
+    //==============================================================================
+    /** Times a stage from construction to destruction. */
+    class ScopedStage
+    {
+        CallbackProfiler & mProfiler;
+        Stage mStage;
+        juce::int64 mStart;
+
+    public:
+        ScopedStage(CallbackProfiler & profiler, Stage const stage) noexcept
+            : mProfiler(profiler)
+            , mStage(stage)
+            , mStart(juce::Time::getHighResolutionTicks())
+        {
+        }
+        ~ScopedStage() { mProfiler.record(mStage, juce::Time::getHighResolutionTicks() - mStart); }
+        SG_DELETE_COPY_AND_MOVE(ScopedStage)
+    };
+
+private:
+    // 1 % of the deadline per bin, the last one catches everything past 2 deadlines.
+    static constexpr auto NUM_BINS = 201;
+    using Histogram = std::array<std::atomic<juce::uint32>, NUM_BINS>;
+
+    std::array<Histogram, NUM_STAGES> mHistograms{};
+    std::array<std::atomic<float>, NUM_STAGES> mMax{};
+    // Audio thread only.
+    double mDeadlineTicks{};
+    // Message thread only.
+    std::array<std::array<juce::uint32, NUM_BINS>, NUM_STAGES> mLastCounts{};
+
+public:
+    //==============================================================================
+    CallbackProfiler() = default;
+    ~CallbackProfiler() = default;
+    SG_DELETE_COPY_AND_MOVE(CallbackProfiler)
+    //==============================================================================
+    /** Audio thread : has to be called at the start of every block. */
+    void startBlock(int numSamples, double sampleRate) noexcept;
+    /** Audio thread : returns the duration as a fraction of the block deadline. */
+    float record(Stage stage, juce::int64 ticks) noexcept;
+    //==============================================================================
+    /** Message thread : the stats of the blocks processed since the previous call. */
+    [[nodiscard]] Stats collectStats();
+    [[nodiscard]] static juce::String stageToString(Stage stage);
+
+private:
+    //==============================================================================
+    JUCE_LEAK_DETECTOR(CallbackProfiler)
+};
+
+} // namespace gris
@@ -22,6 +22,8 @@
 namespace gris
 {
 juce::String const Configuration::XmlTags::MAIN_TAG = "SpatGRIS app data";
+juce::String const Configuration::XmlTags::JITTER_BUFFER_DELAY = "SpatGRIS jitter buffer delay";
+juce::String const Configuration::XmlTags::SOURCE_GATING = "SpatGRIS source gating";
 
 //==============================================================================
 Configuration::Configuration()
@@ -71,4 +73,28 @@ AppData Configuration::load() const
     return AppData{};
 }
 
+//==============================================================================
+void Configuration::saveJitterBufferDelay(int const delayMs) const
+{
+    mUserSettings->setValue(XmlTags::JITTER_BUFFER_DELAY, delayMs);
+}
+
+//==============================================================================
+int Configuration::loadJitterBufferDelay() const
+{
+    return mUserSettings->getIntValue(XmlTags::JITTER_BUFFER_DELAY);
+}
+
+//==============================================================================
+void Configuration::saveSourceGating(bool const isEnabled) const
+{
+    mUserSettings->setValue(XmlTags::SOURCE_GATING, isEnabled);
+}
+
+//==============================================================================
+bool Configuration::loadSourceGating() const
+{
+    return mUserSettings->getBoolValue(XmlTags::SOURCE_GATING, true);
+}
+
 } // namespace gris
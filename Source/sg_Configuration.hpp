@@ -29,6 +29,8 @@ class Configuration
 {
     struct XmlTags {
         static juce::String const MAIN_TAG;
+        static juce::String const JITTER_BUFFER_DELAY;
+        static juce::String const SOURCE_GATING;
     };
 
     juce::ApplicationProperties mApplicationProperties{};
@@ -42,6 +44,12 @@ public:
     //==============================================================================
     void save(AppData const & appData) const;
     [[nodiscard]] AppData load() const;
+    /** Has to be saved after the app data. */
+    void saveJitterBufferDelay(int delayMs) const;
+    [[nodiscard]] int loadJitterBufferDelay() const;
+    /** Has to be saved after the app data. */
+    void saveSourceGating(bool isEnabled) const;
+    [[nodiscard]] bool loadSourceGating() const;
 
 private:
     //==============================================================================
@@ -50,6 +50,7 @@ GainsSubPanel::GainsSubPanel(MainContentComponent & mainContentComponent, GrisLo
     JUCE_ASSERT_MESSAGE_THREAD;
     addSection(mMasterGainSlider).withChildMinSize();
     addSection(mInterpolationSlider).withChildMinSize();
+    addSection(mJitterBufferSlider).withChildMinSize();
 }
 
 //==============================================================================
@@ -66,6 +67,13 @@ void GainsSubPanel::setInterpolation(float const interpolation)
     mInterpolationSlider.setValue(interpolation);
 }
 
+//==============================================================================
+void GainsSubPanel::setJitterBufferDelay(int const delayMs)
+{
+    JUCE_ASSERT_MESSAGE_THREAD;
+    mJitterBufferSlider.setValue(static_cast<float>(delayMs));
+}
+
 //==============================================================================
 void GainsSubPanel::sliderMoved(float const value, SpatSlider * const slider)
 {
@@ -76,6 +84,11 @@ void GainsSubPanel::sliderMoved(float const value, SpatSlider * const slider)
         return;
     }
 
+    if (slider == &mJitterBufferSlider) {
+        mMainContentComponent.jitterBufferDelayChanged(juce::roundToInt(value));
+        return;
+    }
+
     jassert(slider == &mInterpolationSlider);
     mMainContentComponent.interpolationChanged(value);
 }
@@ -139,7 +152,8 @@ SpatSettingsSubPanel::SpatSettingsSubPanel(ControlPanel & controlPanel,
     initButton(mMulticoreDSPToggle,
                "Multicore DSP",
                "Experimental : This will use more CPU resources but can perform better on large speaker setups. Does "
-               "not parallelize stereo or binaural reductions.",
+               "not parallelize stereo or binaural reductions. In hybrid mode, the MBAP sources are rendered on a "
+               "second core while the VBAP ones are on the first.",
                NOT_A_RADIO_BUTTON_ID);
     initButton(mMulticoreDSPCPUPresetToggle,
                "A",
@@ -149,6 +163,10 @@ SpatSettingsSubPanel::SpatSettingsSubPanel(ControlPanel & controlPanel,
                "B",
                "This preset uses more idle CPU but can perform better.",
                MULTICORE_PRESETS_RADIO_GROUP_ID);
+    initButton(mMulticoreDSPAutomaticPresetToggle,
+               "Auto",
+               "Switches between A and B depending on how close the audio processing gets to its deadline.",
+               MULTICORE_PRESETS_RADIO_GROUP_ID);
 
     juce::StringArray items{ "None" };
     items.addArray(STEREO_MODE_STRINGS);
@@ -201,8 +219,10 @@ SpatSettingsSubPanel::SpatSettingsSubPanel(ControlPanel & controlPanel,
     mStereoRoutingLayout.addSection(mRightCombo).withFixedSize(COL_2_QUARTER_WIDTH + COL_2_SPACER);
 
     mMulticoreLayout.addSection(mMulticoreDSPToggle).withFixedSize(COL_2_HALF_WIDTH);
-    mMulticoreLayout.addSection(mMulticoreDSPCPUPresetToggle).withFixedSize(COL_2_QUARTER_WIDTH);
-    mMulticoreLayout.addSection(mMulticoreDSPLatencyPresetToggle).withFixedSize(COL_2_QUARTER_WIDTH);
+    static constexpr auto COL_2_SIXTH_WIDTH = COL_2_HALF_WIDTH / 3;
+    mMulticoreLayout.addSection(mMulticoreDSPCPUPresetToggle).withFixedSize(COL_2_SIXTH_WIDTH);
+    mMulticoreLayout.addSection(mMulticoreDSPLatencyPresetToggle).withFixedSize(COL_2_SIXTH_WIDTH);
+    mMulticoreLayout.addSection(mMulticoreDSPAutomaticPresetToggle).withFixedSize(COL_2_SIXTH_WIDTH);
 
     mCol2Layout.addSection(mAttenuationSettingsButton).withFixedSize(LABEL_HEIGHT);
     mCol2Layout.addSection(mAttenuationLayout).withFixedSize(ROW_1_CONTENT_HEIGHT).withBottomPadding(ROW_PADDING);
@@ -332,10 +352,21 @@ void SpatSettingsSubPanel::setMulticoreDSPPreset(int preset)
         mMulticoreDSPCPUPresetToggle.setToggleState(true, juce::dontSendNotification);
     } else if (preset == OPTIMIZE_LATENCY_MULTICORE_PRESET) {
         mMulticoreDSPLatencyPresetToggle.setToggleState(true, juce::dontSendNotification);
+    } else if (preset == MulticoreDSPTuner::AUTOMATIC_PRESET) {
+        mMulticoreDSPAutomaticPresetToggle.setToggleState(true, juce::dontSendNotification);
     }
     JUCE_ASSERT_MESSAGE_THREAD;
 }
 
+//==============================================================================
+void SpatSettingsSubPanel::setAutomaticMulticoreDSPPresetDescription(juce::String const & description)
+{
+    JUCE_ASSERT_MESSAGE_THREAD;
+    mMulticoreDSPAutomaticPresetToggle.setTooltip(
+        "Switches between A and B depending on how close the audio processing gets to its deadline.\n"
+        + description);
+}
+
 //==============================================================================
 void SpatSettingsSubPanel::setStereoMode(tl::optional<StereoMode> const & stereoMode)
 {
@@ -433,20 +464,13 @@ void SpatSettingsSubPanel::updateLayout()
 
     mStereoRoutingLabel.setVisible(showRouting);
 
-    // We may have previously set the visibility of these to false.
-    mBottomLeftComponentSwapper.setVisible(true);
-    mTopLeftComponentSwapper.setVisible(true);
     if (showRouting) {
         mBottomLeftComponentSwapper.showComponent(stereoRoutingLayoutName);
         mTopLeftComponentSwapper.showComponent(stereoRoutingLabelName);
-    } // we should not show the multicoreDSPToggle in hybrid mode because it should have no effect.
-    else if (getSpatMode() != SpatMode::hybrid) {
+    } else {
+        // Also in hybrid mode, which renders its two halves in parallel with multicore DSP.
         mBottomLeftComponentSwapper.showComponent(multicoreLayoutName);
         mTopLeftComponentSwapper.showComponent(multicoreLabelName);
-    } else {
-        // if we are in hybrid mode and we should not show routing, hide everything.
-        mBottomLeftComponentSwapper.setVisible(false);
-        mTopLeftComponentSwapper.setVisible(false);
     }
 
     clearSections();
@@ -484,6 +508,8 @@ void SpatSettingsSubPanel::buttonClicked(juce::Button * button)
         mMainContentComponent.setMulticoreDSPPreset(OPTIMIZE_CPU_MULTICORE_PRESET);
     } else if (button == &mMulticoreDSPLatencyPresetToggle && button->getToggleState()) {
         mMainContentComponent.setMulticoreDSPPreset(OPTIMIZE_LATENCY_MULTICORE_PRESET);
+    } else if (button == &mMulticoreDSPAutomaticPresetToggle && button->getToggleState()) {
+        mMainContentComponent.setMulticoreDSPPreset(MulticoreDSPTuner::AUTOMATIC_PRESET);
     }
 }
 
@@ -548,6 +574,13 @@ void ControlPanel::setInterpolation(float const interpolation)
     mGainsSubPanel.setInterpolation(interpolation);
 }
 
+//==============================================================================
+void ControlPanel::setJitterBufferDelay(int const delayMs)
+{
+    JUCE_ASSERT_MESSAGE_THREAD;
+    mGainsSubPanel.setJitterBufferDelay(delayMs);
+}
+
 //==============================================================================
 void ControlPanel::setSpatMode(SpatMode const spatMode)
 {
@@ -567,6 +600,11 @@ void ControlPanel::setMulticoreDSPPreset(int preset)
     JUCE_ASSERT_MESSAGE_THREAD;
     mSpatSettingsSubPanel.setMulticoreDSPPreset(preset);
 }
+void ControlPanel::setAutomaticMulticoreDSPPresetDescription(juce::String const & description)
+{
+    JUCE_ASSERT_MESSAGE_THREAD;
+    mSpatSettingsSubPanel.setAutomaticMulticoreDSPPresetDescription(description);
+}
 
 //==============================================================================
 void ControlPanel::setStereoMode(tl::optional<StereoMode> const & mode)
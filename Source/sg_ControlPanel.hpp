@@ -23,8 +23,10 @@
 #include "Data/sg_constants.hpp"
 #include "sg_GeneralMuteButton.hpp"
 #include "sg_LayoutComponent.hpp"
+#include "sg_MulticoreDSPTuner.hpp"
 #include "sg_NumSlider.hpp"
 #include "sg_RecordButton.hpp"
+#include "sg_SourcePositionJitterBuffer.hpp"
 #include "sg_SpatSlider.hpp"
 #include "sg_SubPanelComponent.hpp"
 #include "sg_TitledComponent.hpp"
@@ -53,6 +55,15 @@ class GainsSubPanel final
     SpatSlider mInterpolationSlider{
         0.0f, 1.0f, 0.01f, "", "Interpolation", "Determines how much source panning is smoothed", *this, mLookAndFeel
     };
+    SpatSlider mJitterBufferSlider{ 0.0f,
+                                    static_cast<float>(SourcePositionJitterBuffer::MAX_DELAY_MS),
+                                    1.0f,
+                                    " ms",
+                                    "OSC smoothing",
+                                    "Delays the positions received by OSC to smooth out the motion of controllers that "
+                                    "send them in bursts. 0 disables it.",
+                                    *this,
+                                    mLookAndFeel };
 
 public:
     //==============================================================================
@@ -62,6 +73,7 @@ public:
     //==============================================================================
     void setMasterGain(dbfs_t gain);
     void setInterpolation(float interpolation);
+    void setJitterBufferDelay(int delayMs);
     //==============================================================================
     void sliderMoved(float value, SpatSlider * slider) override;
 
@@ -112,6 +124,7 @@ class SpatSettingsSubPanel final
     juce::TextButton mMulticoreDSPToggle{};
     juce::TextButton mMulticoreDSPCPUPresetToggle{};
     juce::TextButton mMulticoreDSPLatencyPresetToggle{};
+    juce::TextButton mMulticoreDSPAutomaticPresetToggle{};
     /**
      * Used to swap the multicore DSP toggles and the stereo routing dropdowns.
      */
@@ -139,6 +152,8 @@ public:
     void setSpatMode(SpatMode spatMode);
     void setMulticoreDSP(bool useMulticoreDSP);
     void setMulticoreDSPPreset(int preset);
+    /** Tells which preset the automatic mode currently picked. */
+    void setAutomaticMulticoreDSPPresetDescription(juce::String const & description);
     void setStereoMode(tl::optional<StereoMode> const & stereoMode);
     void setAttenuationDb(dbfs_t attenuation);
     void setAttenuationHz(hz_t freq);
@@ -191,9 +206,11 @@ public:
     //==============================================================================
     void setMasterGain(dbfs_t gain);
     void setInterpolation(float interpolation);
+    void setJitterBufferDelay(int delayMs);
     void setSpatMode(SpatMode spatMode);
     void setMulticoreDSP(bool useMulticoreDSP);
     void setMulticoreDSPPreset(int preset);
+    void setAutomaticMulticoreDSPPresetDescription(juce::String const & description);
     void setStereoMode(tl::optional<StereoMode> const & mode);
     void setCubeAttenuationDb(dbfs_t value);
     void setCubeAttenuationHz(hz_t value);
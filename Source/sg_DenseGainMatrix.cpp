@@ -0,0 +1,178 @@
+/*
+ This file is part of SpatGRIS.
+
+ Developers: Gaël Lane Lépine, Samuel Béland, Olivier Bélanger, Nicolas Masson
+
+ SpatGRIS is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ SpatGRIS is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with SpatGRIS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sg_DenseGainMatrix.hpp"
+
+#include "Data/sg_constants.hpp"
+#include "sg_AudioKernels.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace gris
+{
+namespace
+{
+// 64 samples of one source and of every speaker of a pass : well under the size of any L1 cache.
+constexpr auto TILE_SIZE = 64;
+constexpr auto SPEAKERS_PER_PASS = 4;
+
+struct Ramp {
+    float gain{};
+    float increment{};
+};
+
+using PassOutputs = std::array<float *, SPEAKERS_PER_PASS>;
+using PassRamps = std::array<Ramp, SPEAKERS_PER_PASS>;
+
+//==============================================================================
+/** Adds one source to the speakers of a pass. The gains are the ones of the first sample of the tile. */
+void mixPass(float const * const input,
+             PassOutputs const & outputs,
+             PassRamps const & ramps,
+             int const numSamples) noexcept
+{
+    int i{};
+#if JUCE_USE_SIMD
+    using kernels::Vec;
+    using kernels::VEC_SIZE;
+
+    std::array<float, Vec::SIMDNumElements> laneIndices{};
+    for (size_t lane{}; lane < laneIndices.size(); ++lane) {
+        laneIndices[lane] = static_cast<float>(lane);
+    }
+    auto const lanes{ kernels::load(laneIndices.data()) };
+
+    std::array<Vec, SPEAKERS_PER_PASS> gains{};
+    std::array<Vec, SPEAKERS_PER_PASS> increments{};
+    for (size_t speaker{}; speaker < SPEAKERS_PER_PASS; ++speaker) {
+        auto const & ramp{ ramps[speaker] };
+        gains[speaker] = Vec::expand(ramp.gain) + lanes * Vec::expand(ramp.increment);
+        increments[speaker] = Vec::expand(ramp.increment * static_cast<float>(VEC_SIZE));
+    }
+
+    for (; i + VEC_SIZE <= numSamples; i += VEC_SIZE) {
+        auto const samples{ kernels::load(input + i) };
+        for (size_t speaker{}; speaker < SPEAKERS_PER_PASS; ++speaker) {
+            auto * const output{ outputs[speaker] + i };
+            kernels::store(kernels::load(output) + samples * gains[speaker], output);
+            gains[speaker] = gains[speaker] + increments[speaker];
+        }
+    }
+#endif
+    for (; i < numSamples; ++i) {
+        for (size_t speaker{}; speaker < SPEAKERS_PER_PASS; ++speaker) {
+            auto const & ramp{ ramps[speaker] };
+            outputs[speaker][i] += input[i] * (ramp.gain + ramp.increment * static_cast<float>(i));
+        }
+    }
+}
+
+} // namespace
+
+//==============================================================================
+DenseGainMatrix::DenseGainMatrix(int const numSources, int const numSpeakers, int const rampLength)
+    : mNumSources(numSources)
+    , mNumSpeakers(numSpeakers)
+    , mGains(static_cast<size_t>(numSources * numSpeakers))
+    , mTargetGains(static_cast<size_t>(numSources * numSpeakers))
+    , mRampLength(rampLength)
+    , mDiscardedSamples(static_cast<size_t>(TILE_SIZE))
+{
+    jassert(numSources >= 0 && numSpeakers >= 0 && rampLength >= 0);
+}
+
+//==============================================================================
+void DenseGainMatrix::setTargetGains(int const source, float const * const gains) noexcept
+{
+    std::copy_n(gains, mNumSpeakers, mTargetGains.begin() + source * mNumSpeakers);
+    if (mRampLength == 0) {
+        std::copy_n(gains, mNumSpeakers, mGains.begin() + source * mNumSpeakers);
+    }
+    // Restarts from wherever the other sources are in their ramps : they get there a bit later, but without a jump.
+    mNumRampSamplesLeft = mRampLength;
+}
+
+//==============================================================================
+void DenseGainMatrix::mix(float const * const * const sources,
+                          float * const * const speakers,
+                          int const numSamples) noexcept
+{
+    auto const numRampSamples{ std::min(numSamples, mNumRampSamplesLeft) };
+    if (numRampSamples > 0) {
+        auto const rampFactor{ 1.0f / static_cast<float>(mNumRampSamplesLeft) };
+        mixSamples(sources, speakers, 0, numRampSamples, rampFactor);
+
+        mNumRampSamplesLeft -= numRampSamples;
+        if (mNumRampSamplesLeft == 0) {
+            mGains = mTargetGains;
+        } else {
+            auto const progress{ static_cast<float>(numRampSamples) * rampFactor };
+            for (size_t i{}; i < mGains.size(); ++i) {
+                mGains[i] += (mTargetGains[i] - mGains[i]) * progress;
+            }
+        }
+    }
+
+    if (numRampSamples < numSamples) {
+        mixSamples(sources, speakers, numRampSamples, numSamples, 0.0f);
+    }
+}
+
+//==============================================================================
+void DenseGainMatrix::mixSamples(float const * const * const sources,
+                                 float * const * const speakers,
+                                 int const begin,
+                                 int const end,
+                                 float const rampFactor) noexcept
+{
+    for (int tileStart{ begin }; tileStart < end; tileStart += TILE_SIZE) {
+        auto const tileSize{ std::min(TILE_SIZE, end - tileStart) };
+
+        for (int firstSpeaker{}; firstSpeaker < mNumSpeakers; firstSpeaker += SPEAKERS_PER_PASS) {
+            PassOutputs outputs{};
+            for (size_t i{}; i < SPEAKERS_PER_PASS; ++i) {
+                auto const speaker{ firstSpeaker + static_cast<int>(i) };
+                outputs[i] = speaker < mNumSpeakers ? speakers[speaker] + tileStart : mDiscardedSamples.data();
+            }
+
+            for (int source{}; source < mNumSources; ++source) {
+                PassRamps ramps{};
+                auto isSilent{ true };
+                for (size_t i{}; i < SPEAKERS_PER_PASS; ++i) {
+                    auto const speaker{ firstSpeaker + static_cast<int>(i) };
+                    if (speaker >= mNumSpeakers) {
+                        break;
+                    }
+                    auto const index{ static_cast<size_t>(source * mNumSpeakers + speaker) };
+                    auto const gain{ mGains[index] };
+                    auto const increment{ (mTargetGains[index] - gain) * rampFactor };
+                    ramps[i] = Ramp{ gain + increment * static_cast<float>(tileStart - begin), increment };
+                    isSilent = isSilent && std::abs(gain) < SMALL_GAIN && std::abs(mTargetGains[index]) < SMALL_GAIN;
+                }
+                if (!isSilent) {
+                    mixPass(sources[source] + tileStart, outputs, ramps, tileSize);
+                }
+            }
+        }
+    }
+}
+
+} // namespace gris
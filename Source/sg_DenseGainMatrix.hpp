@@ -0,0 +1,87 @@
+/*
+ This file is part of SpatGRIS.
+
+ Developers: Gaël Lane Lépine, Samuel Béland, Olivier Bélanger, Nicolas Masson
+
+ SpatGRIS is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ SpatGRIS is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with SpatGRIS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Data/sg_Macros.hpp"
+
+#include <JuceHeader.h>
+#include <vector>
+
+namespace gris
+{
+//==============================================================================
+/** The gains from every source to every speaker, mixed as a whole.
+ *
+ * MBAP spreads each source over most of the cube, so mixing is basically a matrix product per block. Going through the
+ * pairs one by one would stream every speaker buffer once per source. Instead, mix() works on tiles of samples small
+ * enough to stay in the L1 cache and, inside a tile, mixes every source into a few speakers at a time, so that each
+ * input sample is loaded once for all of them.
+ *
+ * The gains ramp to their targets over a fixed number of samples, whatever the size of the blocks : a ramp can span
+ * several blocks, or end in the middle of one. Gains can be negative (a decoder matrix, for instance).
+ *
+ * Sources and speakers are plain indices starting at 0. All the memory is allocated by the constructor, so that
+ * setTargetGains() and mix() can run on the audio thread. Nothing is synchronized : both have to be called from the
+ * thread that renders the block.
+ *
+ * Nothing renders through it yet : the MBAP mix lives in AlgoGRIS and still goes pair by pair. For now, only the
+ * --mixing benchmark uses it, to measure whether switching MBAP over would pay off.
+ */
+class DenseGainMatrix
+{
+    int mNumSources{};
+    int mNumSpeakers{};
+    // Source-major : the gains of a source to neighbouring speakers are contiguous.
+    std::vector<float> mGains{};
+    std::vector<float> mTargetGains{};
+    int mRampLength{};
+    int mNumRampSamplesLeft{};
+    // Stands in for the missing speakers of the last pass.
+    std::vector<float> mDiscardedSamples{};
+
+public:
+    //==============================================================================
+    /** A ramp length of 0 makes the gains jump to their targets. */
+    DenseGainMatrix(int numSources, int numSpeakers, int rampLength);
+    DenseGainMatrix() = delete;
+    ~DenseGainMatrix() = default;
+    SG_DELETE_COPY_AND_MOVE(DenseGainMatrix)
+    //==============================================================================
+    /** Sets the gains that a source ramps to, starting with the next mix(). There must be one gain per speaker. */
+    void setTargetGains(int source, float const * gains) noexcept;
+    /** Adds every source to every speaker, going on with the ramp if one is not over. */
+    void mix(float const * const * sources, float * const * speakers, int numSamples) noexcept;
+    //==============================================================================
+    [[nodiscard]] int getNumSources() const noexcept { return mNumSources; }
+    [[nodiscard]] int getNumSpeakers() const noexcept { return mNumSpeakers; }
+
+private:
+    //==============================================================================
+    /** Mixes the samples in [begin, end) with gains that change by (target - gain) * rampFactor per sample. */
+    void mixSamples(float const * const * sources,
+                    float * const * speakers,
+                    int begin,
+                    int end,
+                    float rampFactor) noexcept;
+    //==============================================================================
+    JUCE_LEAK_DETECTOR(DenseGainMatrix)
+};
+
+} // namespace gris
@@ -0,0 +1,173 @@
+/*
+ This file is part of SpatGRIS.
+
+ Developers: Gaël Lane Lépine, Samuel Béland, Olivier Bélanger, Nicolas Masson
+
+ SpatGRIS is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ SpatGRIS is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with SpatGRIS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sg_DropoutLedger.hpp"
+
+#include <algorithm>
+
+namespace gris
+{
+namespace
+{
+//==============================================================================
+juce::String timeToString(juce::int64 const timeMs)
+{
+    return juce::Time{ timeMs }.toString(true, true, true, true);
+}
+
+} // namespace
+
+//==============================================================================
+void DropoutLedger::report(Cause const cause, float const load) noexcept
+{
+    // There is only one writer, so there is no need for a read-modify-write.
+    auto & count{ mCounts[static_cast<size_t>(cause)] };
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    auto const scope{ mFifo.write(1) };
+    if (scope.blockSize1 == 0) {
+        mNumLostEvents.store(mNumLostEvents.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+    mFifoEvents[static_cast<size_t>(scope.startIndex1)] = Event{ cause, juce::Time::currentTimeMillis(), load };
+}
+
+//==============================================================================
+bool DropoutLedger::collect()
+{
+    JUCE_ASSERT_MESSAGE_THREAD;
+
+    auto const numReady{ mFifo.getNumReady() };
+    if (numReady == 0) {
+        return false;
+    }
+
+    auto const scope{ mFifo.read(numReady) };
+    scope.forEach([this](int const index) { mHistory.add(mFifoEvents[static_cast<size_t>(index)]); });
+
+    if (mHistory.size() > MAX_HISTORY_SIZE) {
+        mHistory.removeRange(0, mHistory.size() - MAX_HISTORY_SIZE);
+    }
+    return true;
+}
+
+//==============================================================================
+int DropoutLedger::getCount(Cause const cause) const noexcept
+{
+    auto const index{ static_cast<size_t>(cause) };
+    return static_cast<int>(mCounts[index].load(std::memory_order_relaxed) - mClearedCounts[index]);
+}
+
+//==============================================================================
+int DropoutLedger::getTotalCount() const noexcept
+{
+    int result{};
+    for (size_t i{}; i < NUM_CAUSES; ++i) {
+        result += getCount(static_cast<Cause>(i));
+    }
+    return result;
+}
+
+//==============================================================================
+int DropoutLedger::getNumLostEvents() const noexcept
+{
+    return static_cast<int>(mNumLostEvents.load(std::memory_order_relaxed) - mClearedNumLostEvents);
+}
+
+//==============================================================================
+void DropoutLedger::clear()
+{
+    JUCE_ASSERT_MESSAGE_THREAD;
+
+    // The counters belong to the audio thread : remember where they were instead of resetting them.
+    for (size_t i{}; i < NUM_CAUSES; ++i) {
+        mClearedCounts[i] = mCounts[i].load(std::memory_order_relaxed);
+    }
+    mClearedNumLostEvents = mNumLostEvents.load(std::memory_order_relaxed);
+    collect();
+    mHistory.clearQuick();
+    mStartTimeMs = juce::Time::currentTimeMillis();
+}
+
+//==============================================================================
+juce::String DropoutLedger::toString(int const maxNumEvents) const
+{
+    juce::String result{ "Since " + timeToString(mStartTimeMs) + "\n" };
+    for (size_t i{}; i < NUM_CAUSES; ++i) {
+        auto const cause{ static_cast<Cause>(i) };
+        result << causeToString(cause) << " : " << getCount(cause) << "\n";
+    }
+    if (auto const numLostEvents{ getNumLostEvents() }; numLostEvents > 0) {
+        result << "(" << numLostEvents << " events could not be logged)\n";
+    }
+    result << "\n";
+
+    auto const firstEvent{ std::max(0, mHistory.size() - maxNumEvents) };
+    for (int i{ mHistory.size() - 1 }; i >= firstEvent; --i) {
+        auto const & event{ mHistory.getReference(i) };
+        result << timeToString(event.timeMs) << "  " << causeToString(event.cause);
+        if (event.cause == Cause::deadlineOverrun) {
+            result << " (" << juce::roundToInt(event.load * 100.0f) << " % of the block)";
+        }
+        result << "\n";
+    }
+
+    return result;
+}
+
+//==============================================================================
+bool DropoutLedger::exportToFile(juce::File const & file) const
+{
+    JUCE_ASSERT_MESSAGE_THREAD;
+
+    juce::String content{ "time,cause,load\n" };
+    for (auto const & event : mHistory) {
+        content << juce::Time{ event.timeMs }.toISO8601(true) << "," << causeToString(event.cause) << ","
+                << juce::String{ event.load, 3 } << "\n";
+    }
+    content << "\n" << "cause,count\n";
+    for (size_t i{}; i < NUM_CAUSES; ++i) {
+        auto const cause{ static_cast<Cause>(i) };
+        content << causeToString(cause) << "," << getCount(cause) << "\n";
+    }
+    content << "Unlogged events," << getNumLostEvents() << "\n";
+
+    return file.replaceWithText(content);
+}
+
+//==============================================================================
+juce::String DropoutLedger::causeToString(Cause const cause)
+{
+    switch (cause) {
+    case Cause::lockContention:
+        return "Lock contention";
+    case Cause::playerLoading:
+        return "Player loading";
+    case Cause::deadlineOverrun:
+        return "Deadline overrun";
+    case Cause::recorderOverflow:
+        return "Recorder overflow";
+    case Cause::count:
+        break;
+    }
+    jassertfalse;
+    return "";
+}
+
+} // namespace gris
@@ -0,0 +1,93 @@
+/*
+ This file is part of SpatGRIS.
+
+ Developers: Gaël Lane Lépine, Samuel Béland, Olivier Bélanger, Nicolas Masson
+
+ SpatGRIS is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ SpatGRIS is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with SpatGRIS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Data/sg_Macros.hpp"
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+namespace gris
+{
+//==============================================================================
+/** Keeps track of every audio block that was skipped or late, and why.
+ *
+ * The audio thread reports events with report(), which never blocks nor allocates. The message thread regularly calls
+ * collect() to move them into the history that is shown in the DropoutLedgerWindow.
+ */
+class DropoutLedger
+{
+public:
+    enum class Cause { lockContention, playerLoading, deadlineOverrun, recorderOverflow, count };
+    static constexpr auto NUM_CAUSES = static_cast<size_t>(Cause::count);
+
+    struct Event {
+        Cause cause{};
+        juce::int64 timeMs{};
+        /** Duration of the block relative to its deadline. Only meaningful for deadline overruns. */
+        float load{};
+    };
+
+private:
+    static constexpr auto FIFO_CAPACITY = 1024;
+    static constexpr auto MAX_HISTORY_SIZE = 100000;
+
+    juce::AbstractFifo mFifo{ FIFO_CAPACITY };
+    std::array<Event, FIFO_CAPACITY> mFifoEvents{};
+    // Written by the audio thread only.
+    std::array<std::atomic<juce::uint32>, NUM_CAUSES> mCounts{};
+    std::atomic<juce::uint32> mNumLostEvents{};
+    // Message thread only.
+    std::array<juce::uint32, NUM_CAUSES> mClearedCounts{};
+    juce::uint32 mClearedNumLostEvents{};
+    juce::Array<Event> mHistory{};
+    juce::int64 mStartTimeMs{ juce::Time::currentTimeMillis() };
+
+public:
+    //==============================================================================
+    DropoutLedger() = default;
+    ~DropoutLedger() = default;
+    SG_DELETE_COPY_AND_MOVE(DropoutLedger)
+    //==============================================================================
+    /** Audio thread. */
+    void report(Cause cause, float load = 0.0f) noexcept;
+    //==============================================================================
+    /** Message thread : moves the reported events to the history. Returns true if there were any. */
+    bool collect();
+    [[nodiscard]] juce::Array<Event> const & getHistory() const noexcept { return mHistory; }
+    [[nodiscard]] int getCount(Cause cause) const noexcept;
+    [[nodiscard]] int getTotalCount() const noexcept;
+    /** Events that happened but could not be timestamped because the message thread was too slow to collect them. */
+    [[nodiscard]] int getNumLostEvents() const noexcept;
+    void clear();
+    /** The counts followed by the most recent events, newest first. */
+    [[nodiscard]] juce::String toString(int maxNumEvents) const;
+    /** Writes the counts and every event as CSV. */
+    [[nodiscard]] bool exportToFile(juce::File const & file) const;
+    //==============================================================================
+    [[nodiscard]] static juce::String causeToString(Cause cause);
+
+private:
+    //==============================================================================
+    JUCE_LEAK_DETECTOR(DropoutLedger)
+};
+
+} // namespace gris
@@ -0,0 +1,152 @@
+/*
+ This file is part of SpatGRIS.
+
+ Developers: Gaël Lane Lépine, Samuel Béland, Olivier Bélanger, Nicolas Masson
+
+ SpatGRIS is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ SpatGRIS is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with SpatGRIS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sg_DropoutLedgerWindow.hpp"
+
+#include "sg_GrisLookAndFeel.hpp"
+#include "sg_MainComponent.hpp"
+
+namespace gris
+{
+namespace
+{
+constexpr auto DEFAULT_WIDTH = 600;
+constexpr auto DEFAULT_HEIGHT = 500;
+constexpr auto MAX_DISPLAYED_EVENTS = 1000;
+constexpr auto REFRESH_RATE_HZ = 2;
+
+} // namespace
+
+//==============================================================================
+DropoutLedgerComponent::DropoutLedgerComponent(DropoutLedger & ledger) : mLedger(ledger)
+{
+    mTextEditor.setCaretVisible(false);
+    mTextEditor.setReadOnly(true);
+    mTextEditor.setBorder(juce::BorderSize<int>{ 3 });
+    mTextEditor.setMultiLine(true, false);
+    mTextEditor.setScrollbarsShown(true);
+    addAndMakeVisible(mTextEditor);
+
+    mClearButton.setButtonText("Clear");
+    mClearButton.addListener(this);
+    addAndMakeVisible(mClearButton);
+
+    mExportButton.setButtonText("Export...");
+    mExportButton.addListener(this);
+    addAndMakeVisible(mExportButton);
+
+    refresh();
+    startTimerHz(REFRESH_RATE_HZ);
+}
+
+//==============================================================================
+void DropoutLedgerComponent::buttonClicked(juce::Button * button)
+{
+    if (button == &mClearButton) {
+        mLedger.clear();
+        refresh();
+        return;
+    }
+
+    jassert(button == &mExportButton);
+    auto const initialFile{ juce::File::getSpecialLocation(juce::File::SpecialLocationType::userDocumentsDirectory)
+                                .getChildFile("SpatGRIS dropouts " + juce::Time::getCurrentTime().formatted("%Y-%m-%d")
+                                              + ".csv") };
+    juce::FileChooser fc{ "Choose file to save to...", initialFile, "*.csv", true, false, this };
+    if (!fc.browseForFileToSave(true)) {
+        return;
+    }
+
+    mLedger.collect();
+    if (!mLedger.exportToFile(fc.getResult())) {
+        juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::AlertIconType::WarningIcon,
+                                               "Error",
+                                               "Unable to write to " + fc.getResult().getFullPathName() + ".",
+                                               "Ok",
+                                               this);
+    }
+}
+
+//==============================================================================
+void DropoutLedgerComponent::resized()
+{
+    static auto constexpr BUTTON_WIDTH = 100;
+    static auto constexpr BUTTON_HEIGHT = 30;
+    static auto constexpr PADDING = 5;
+
+    auto bounds{ getLocalBounds().reduced(PADDING) };
+    auto buttonsBounds{ bounds.removeFromBottom(BUTTON_HEIGHT) };
+    bounds.removeFromBottom(PADDING);
+
+    mTextEditor.setBounds(bounds);
+    mExportButton.setBounds(buttonsBounds.removeFromRight(BUTTON_WIDTH));
+    buttonsBounds.removeFromRight(PADDING);
+    mClearButton.setBounds(buttonsBounds.removeFromRight(BUTTON_WIDTH));
+}
+
+//==============================================================================
+void DropoutLedgerComponent::timerCallback()
+{
+    // The main component keeps collecting the events : only redraw when something changed.
+    if (mLedger.getTotalCount() != mLastDisplayedTotal) {
+        refresh();
+    }
+}
+
+//==============================================================================
+void DropoutLedgerComponent::refresh()
+{
+    mLedger.collect();
+    mLastDisplayedTotal = mLedger.getTotalCount();
+    mTextEditor.setText(mLedger.toString(MAX_DISPLAYED_EVENTS));
+}
+
+//==============================================================================
+DropoutLedgerWindow::DropoutLedgerWindow(DropoutLedger & ledger,
+                                         MainContentComponent & mainContentComponent,
+                                         GrisLookAndFeel & glaf)
+    : DocumentWindow("Dropouts", glaf.getBackgroundColour(), allButtons)
+    , mMainContentComponent(mainContentComponent)
+    , mComponent(ledger)
+{
+    setUsingNativeTitleBar(true);
+    setResizable(true, true);
+    setContentNonOwned(&mComponent, false);
+    centreAroundComponent(&mainContentComponent, DEFAULT_WIDTH, DEFAULT_HEIGHT);
+    DocumentWindow::setVisible(true);
+}
+
+//==============================================================================
+void DropoutLedgerWindow::closeButtonPressed()
+{
+    mMainContentComponent.closeDropoutLedgerWindow();
+}
+
+//==============================================================================
+bool DropoutLedgerWindow::keyPressed(const juce::KeyPress & key)
+{
+    auto const key_w{ juce::KeyPress(87) };
+    if (key.getModifiers().isCommandDown() && key.isKeyCurrentlyDown(key_w.getKeyCode())) {
+        mMainContentComponent.closeDropoutLedgerWindow();
+        return true;
+    }
+    return false;
+}
+
+} // namespace gris
@@ -0,0 +1,80 @@
+/*
+ This file is part of SpatGRIS.
+
+ Developers: Gaël Lane Lépine, Samuel Béland, Olivier Bélanger, Nicolas Masson
+
+ SpatGRIS is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ SpatGRIS is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with SpatGRIS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "sg_DropoutLedger.hpp"
+
+namespace gris
+{
+class MainContentComponent;
+class GrisLookAndFeel;
+
+//==============================================================================
+class DropoutLedgerComponent final
+    : public juce::Component
+    , private juce::TextButton::Listener
+    , private juce::Timer
+{
+    DropoutLedger & mLedger;
+    int mLastDisplayedTotal{ -1 };
+
+    juce::TextEditor mTextEditor{};
+    juce::TextButton mClearButton{};
+    juce::TextButton mExportButton{};
+
+public:
+    //==============================================================================
+    explicit DropoutLedgerComponent(DropoutLedger & ledger);
+    DropoutLedgerComponent() = delete;
+    ~DropoutLedgerComponent() override = default;
+    SG_DELETE_COPY_AND_MOVE(DropoutLedgerComponent)
+    //==============================================================================
+    void buttonClicked(juce::Button * button) override;
+    void resized() override;
+
+private:
+    //==============================================================================
+    void timerCallback() override;
+    void refresh();
+    //==============================================================================
+    JUCE_LEAK_DETECTOR(DropoutLedgerComponent)
+};
+
+//==============================================================================
+class DropoutLedgerWindow final : public juce::DocumentWindow
+{
+    MainContentComponent & mMainContentComponent;
+    DropoutLedgerComponent mComponent;
+
+public:
+    //==============================================================================
+    DropoutLedgerWindow(DropoutLedger & ledger, MainContentComponent & mainContentComponent, GrisLookAndFeel & lookAndFeel);
+    ~DropoutLedgerWindow() override = default;
+    SG_DELETE_COPY_AND_MOVE(DropoutLedgerWindow)
+    //==============================================================================
+    void closeButtonPressed() override;
+    bool keyPressed(const juce::KeyPress & key) override;
+
+private:
+    //==============================================================================
+    JUCE_LEAK_DETECTOR(DropoutLedgerWindow)
+};
+
+} // namespace gris
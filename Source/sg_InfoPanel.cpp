@@ -24,7 +24,7 @@
 
 namespace
 {
-constexpr auto MIN_WIDTH = 400;
+constexpr auto MIN_WIDTH = 480;
 constexpr auto MIN_HEIGHT = 25;
 auto const COLOR_1 = juce::Colours::blue.withBrightness(0.3f).withSaturation(0.2f);
 auto const COLOR_2 = juce::Colours::blue.withBrightness(0.2f).withSaturation(0.2f);
@@ -111,6 +111,80 @@ void InfoPanel::setNumOutputs(int const numOutputs)
     mNumOutputsLabel.setText(string, juce::dontSendNotification);
 }
 
+//==============================================================================
+void InfoPanel::setCallbackProfile(CallbackProfiler::Stats const & stats)
+{
+    JUCE_ASSERT_MESSAGE_THREAD;
+
+    using Stage = CallbackProfiler::Stage;
+
+    auto const toPercentString
+        = [](float const fraction) { return juce::String{ narrow<int>(std::round(fraction * 100.0f)) } + " %"; };
+
+    auto const & total{ stats[static_cast<size_t>(Stage::total)] };
+    if (total.numBlocks == 0) {
+        mProfileText = "No audio";
+        mProfileLabel.setTooltip({});
+        refreshProfileLabel();
+        return;
+    }
+
+    auto worstStage{ Stage::inputCopy };
+    juce::String tooltip{ "Share of the block deadline (p50 / p99 / max)" };
+    for (size_t i{}; i < stats.size(); ++i) {
+        auto const stage{ static_cast<Stage>(i) };
+        auto const & stageStats{ stats[i] };
+        tooltip << "\n" << CallbackProfiler::stageToString(stage) << " : " << toPercentString(stageStats.p50) << " / "
+                << toPercentString(stageStats.p99) << " / " << toPercentString(stageStats.max);
+        if (stage != Stage::total && stageStats.p99 > stats[static_cast<size_t>(worstStage)].p99) {
+            worstStage = stage;
+        }
+    }
+
+    auto const & worst{ stats[static_cast<size_t>(worstStage)] };
+    mProfileText = CallbackProfiler::stageToString(worstStage) + " p99: " + toPercentString(worst.p99);
+    mProfileLabel.setTooltip(tooltip + "\n\nClick to see the dropouts.");
+    refreshProfileLabel();
+}
+
+//==============================================================================
+void InfoPanel::setNumDropouts(int const numDropouts)
+{
+    JUCE_ASSERT_MESSAGE_THREAD;
+
+    if (numDropouts == mNumDropouts) {
+        return;
+    }
+    mNumDropouts = numDropouts;
+    refreshProfileLabel();
+}
+
+//==============================================================================
+void InfoPanel::setNumProcessedSources(int const numProcessedSources, int const numSources)
+{
+    JUCE_ASSERT_MESSAGE_THREAD;
+
+    if (numProcessedSources == mNumProcessedSources && numSources == mNumSources) {
+        return;
+    }
+    mNumProcessedSources = numProcessedSources;
+    mNumSources = numSources;
+    refreshProfileLabel();
+}
+
+//==============================================================================
+void InfoPanel::refreshProfileLabel()
+{
+    auto text{ mProfileText };
+    if (mNumSources > 0) {
+        text << " | " << mNumProcessedSources << "/" << mNumSources << " active";
+    }
+    if (mNumDropouts > 0) {
+        text << " | " << mNumDropouts << (mNumDropouts == 1 ? " dropout" : " dropouts");
+    }
+    mProfileLabel.setText(text, juce::dontSendNotification);
+}
+
 //==============================================================================
 void InfoPanel::resized()
 {
@@ -131,6 +205,11 @@ void InfoPanel::resized()
 //==============================================================================
 void InfoPanel::mouseDown(juce::MouseEvent const & event)
 {
+    if (event.eventComponent == &mProfileLabel) {
+        mMainContentComponent.handleShowDropoutLedgerWindow();
+        return;
+    }
+
     if (event.eventComponent != &mCpuLabel) {
         mMainContentComponent.handleShowPreferences();
         return;
@@ -163,7 +242,8 @@ juce::Array<juce::Label *> InfoPanel::getLabels() noexcept
                                        &mSampleRateLabel,
                                        &mBufferSizeLabel,
                                        &mNumInputsLabel,
-                                       &mNumOutputsLabel };
+                                       &mNumOutputsLabel,
+                                       &mProfileLabel };
 }
 
 //==============================================================================
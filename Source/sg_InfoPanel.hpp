@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include "sg_CallbackProfiler.hpp"
 #include "sg_MinSizedComponent.hpp"
 
 namespace gris
@@ -36,10 +37,16 @@ class InfoPanel final : public MinSizedComponent
     juce::Label mBufferSizeLabel{};
     juce::Label mNumInputsLabel{};
     juce::Label mNumOutputsLabel{};
+    juce::Label mProfileLabel{};
 
     bool mCpuPeaked{};
     bool mCpuIsCurrentlyPeaking{};
 
+    juce::String mProfileText{};
+    int mNumDropouts{};
+    int mNumProcessedSources{};
+    int mNumSources{};
+
 public:
     //==============================================================================
     explicit InfoPanel(MainContentComponent & mainContentComponent, GrisLookAndFeel const & lookAndFeel);
@@ -51,6 +58,11 @@ public:
     void setBufferSize(int bufferSize);
     void setNumInputs(int numInputs);
     void setNumOutputs(int numOutputs);
+    /** Shows the slowest stage of the audio callback, with every stage listed in the tooltip. */
+    void setCallbackProfile(CallbackProfiler::Stats const & stats);
+    void setNumDropouts(int numDropouts);
+    /** Shows how many sources were spatialized, the others being gated out because they were silent. */
+    void setNumProcessedSources(int numProcessedSources, int numSources);
     //==============================================================================
     void resized() override;
     void mouseDown(juce::MouseEvent const & event) override;
@@ -60,6 +72,7 @@ public:
 private:
     //==============================================================================
     [[nodiscard]] juce::Array<juce::Label *> getLabels() noexcept;
+    void refreshProfileLabel();
     void setComponentsColors(juce::Array<juce::Label *> const & labels);
     //==============================================================================
     JUCE_LEAK_DETECTOR(InfoPanel)
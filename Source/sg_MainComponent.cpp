@@ -136,6 +136,7 @@ MainContentComponent::MainContentComponent(MainWindow & mainWindow,
         if (mData.appData.lastSpeakerSetup.isEmpty())
             mData.appData.lastSpeakerSetup = DEFAULT_SPEAKER_SETUP_FILE.getFullPathName();
         setOscPort(mData.appData.networkSettings.oscPort);
+        mSourcePositionJitterBuffer.setDelayMs(mConfiguration.loadJitterBufferDelay());
     };
 
     //==============================================================================
@@ -175,6 +176,7 @@ MainContentComponent::MainContentComponent(MainWindow & mainWindow,
         mControlPanel->setCubeAttenuationHz(mData.project.mbapDistanceAttenuationData.freq);
         mControlPanel->setStereoMode(mData.appData.stereoMode);
         mControlPanel->setStereoRouting(mData.appData.stereoRouting);
+        mControlPanel->setJitterBufferDelay(mSourcePositionJitterBuffer.getDelayMs());
 
         // Source panel
         mSourcesInnerLayout
@@ -254,9 +256,9 @@ MainContentComponent::MainContentComponent(MainWindow & mainWindow,
     //==============================================================================
     auto const initAudioProcessor = [&]() {
         mAudioProcessor = std::make_unique<AudioProcessor>();
-        juce::ScopedLock const audioLock{ mAudioProcessor->getLock() };
         auto & audioManager{ AudioManager::getInstance() };
         audioManager.registerAudioProcessor(mAudioProcessor.get());
+        mAudioProcessor->setSourceGating(mConfiguration.loadSourceGating());
         AudioManager::getInstance().getAudioDeviceManager().addChangeListener(this);
         audioParametersChanged(); // size of buffers not initialized here...
     };
@@ -289,8 +291,6 @@ MainContentComponent::MainContentComponent(MainWindow & mainWindow,
                                           mData.appData.networkSettings.standaloneSpeakerViewOutputPort,
                                           mData.appData.networkSettings.standaloneSpeakerViewOutputAddress);
 
-    // juce::ScopedLock const audioLock{ mAudioProcessor->getLock() };
-
     startOsc();
     initCommandManager();
 
@@ -320,6 +320,9 @@ MainContentComponent::~MainContentComponent()
         mData.appData.cameraPosition = mSpeakerViewComponent->getCameraPosition().getCartesian();
 
         mConfiguration.save(mData.appData);
+        // After save(), which starts from a clean slate.
+        mConfiguration.saveJitterBufferDelay(mSourcePositionJitterBuffer.getDelayMs());
+        mConfiguration.saveSourceGating(mAudioProcessor->isSourceGatingEnabled());
     }
 
     if (isSpeakerViewProcessRunning()) {
@@ -659,6 +662,23 @@ void MainContentComponent::handleShowOscMonitorWindow()
     }
 }
 
+//==============================================================================
+void MainContentComponent::handleShowDropoutLedgerWindow()
+{
+    JUCE_ASSERT_MESSAGE_THREAD;
+
+    if (!mAudioProcessor) {
+        return;
+    }
+
+    if (mDropoutLedgerWindow == nullptr) {
+        mDropoutLedgerWindow
+            = std::make_unique<DropoutLedgerWindow>(mAudioProcessor->getDropoutLedger(), *this, mLookAndFeel);
+    } else {
+        mDropoutLedgerWindow->toFront(true);
+    }
+}
+
 //==============================================================================
 void MainContentComponent::handleShow2DView()
 {
@@ -897,6 +917,25 @@ void MainContentComponent::interpolationChanged(float const interpolation)
     refreshAudioProcessor();
 }
 
+//==============================================================================
+void MainContentComponent::jitterBufferDelayChanged(int const delayMs)
+{
+    JUCE_ASSERT_MESSAGE_THREAD;
+
+    mSourcePositionJitterBuffer.setDelayMs(delayMs);
+    mControlPanel->setJitterBufferDelay(mSourcePositionJitterBuffer.getDelayMs());
+    // Flushes the positions that are still buffered if it was just disabled.
+    mSpatDataUpdater.wakeUp();
+}
+
+//==============================================================================
+void MainContentComponent::setSourceGating(bool const isEnabled)
+{
+    JUCE_ASSERT_MESSAGE_THREAD;
+
+    mAudioProcessor->setSourceGating(isEnabled);
+}
+
 //==============================================================================
 void MainContentComponent::setSpatMode(SpatMode const spatMode)
 {
@@ -952,8 +991,17 @@ void MainContentComponent::setMulticoreDSPState(const bool state)
 void MainContentComponent::setMulticoreDSPPreset(int preset)
 {
     mData.project.multicoreDSPPreset = preset;
+    mMulticoreDSPTuner.reset();
+    mControlPanel->setAutomaticMulticoreDSPPresetDescription(mMulticoreDSPTuner.getDescription());
     // no need to refresh the spat algorithm for this. It only sets worker thread waiting policy.
-    SpinSleepWait::setPerformancePreset(preset);
+    applyMulticoreDSPPreset();
+}
+
+void MainContentComponent::applyMulticoreDSPPreset()
+{
+    auto const preset{ mData.project.multicoreDSPPreset };
+    SpinSleepWait::setPerformancePreset(preset == MulticoreDSPTuner::AUTOMATIC_PRESET ? mMulticoreDSPTuner.getPreset()
+                                                                                       : preset);
 }
 
 //==============================================================================
@@ -1601,7 +1649,6 @@ bool MainContentComponent::perform(InvocationInfo const & info)
 void MainContentComponent::audioParametersChanged()
 {
     JUCE_ASSERT_MESSAGE_THREAD;
-    juce::ScopedLock const audioLock{ mAudioProcessor->getLock() };
 
     auto * currentAudioDevice{ AudioManager::getInstance().getAudioDeviceManager().getCurrentAudioDevice() };
 
@@ -1626,6 +1673,7 @@ void MainContentComponent::audioParametersChanged()
 
         mInfoPanel->setSampleRate(sampleRate);
         mInfoPanel->setBufferSize(bufferSize);
+        mSpatDataUpdater.setBlockDuration(static_cast<double>(bufferSize) / sampleRate);
         mInfoPanel->setNumInputs(inputCount);
         mInfoPanel->setNumOutputs(outputCount);
 
@@ -1996,69 +2044,144 @@ void MainContentComponent::updateSourceSpatData(source_index_t const sourceIndex
     mAudioProcessor->getSpatAlgorithm()->updateSpatData(sourceIndex, mData.project.sources[sourceIndex]);
 }
 
+//==============================================================================
+tl::optional<juce::int64> MainContentComponent::updateSourcesSpatData(juce::Array<source_index_t> const & sources)
+{
+    jassert(!isProbablyAudioThread());
+
+    mSpatDataBatch.clearQuick();
+    mSpatDataBatch.addArray(sources);
+    tl::optional<juce::int64> nextScheduledTimeMs{};
+    {
+        // A single write lock for the whole batch, however many messages the OSC thread received in the meantime.
+        juce::ScopedWriteLock const lock{ mLock };
+
+        // Before the mailboxes : once the jitter buffer is disabled, what it still holds is older than their content.
+        auto const isSmoothing{ mSourcePositionJitterBuffer.process(
+            juce::Time::getMillisecondCounterHiRes(),
+            [&](source_index_t const sourceIndex, SourcePositionMailboxes::Message const & smoothedMessage) {
+                applySourcePositionMessage(sourceIndex, smoothedMessage);
+                mSpatDataBatch.addIfNotAlreadyThere(sourceIndex);
+            }) };
+
+        SourcePositionMailboxes::Message message{};
+        for (auto const sourceIndex : sources) {
+            if (mSourcePositionMailboxes.collect(sourceIndex, message)) {
+                applySourcePositionMessage(sourceIndex, message);
+            }
+        }
+
+        // What is applied now is heard from the next block : the scheduled positions are released one block early.
+        auto const blockDurationMs{ mSpatDataUpdater.getBlockDurationMs() };
+        auto const releaseTimeMs{ juce::Time::currentTimeMillis() + blockDurationMs };
+        nextScheduledTimeMs = mPositionSchedule.releaseDue(releaseTimeMs, [&](PositionSchedule::Event const & event) {
+            applySourcePositionMessage(event.sourceIndex, event.message);
+            mSpatDataBatch.addIfNotAlreadyThere(event.sourceIndex);
+        });
+        if (nextScheduledTimeMs) {
+            *nextScheduledTimeMs -= blockDurationMs;
+        }
+        if (isSmoothing) {
+            // The smoothed sources move a little more with every block.
+            nextScheduledTimeMs = juce::Time::currentTimeMillis();
+        }
+    }
+
+    juce::ScopedReadLock const lock{ mLock };
+    auto * spatAlgorithm{ mAudioProcessor->getSpatAlgorithm() };
+    if (spatAlgorithm == nullptr) {
+        return nextScheduledTimeMs;
+    }
+    for (auto const sourceIndex : mSpatDataBatch) {
+        // The source might have been removed since it was flagged.
+        if (mData.project.sources.contains(sourceIndex)) {
+            spatAlgorithm->updateSpatData(sourceIndex, mData.project.sources[sourceIndex]);
+        }
+    }
+    return nextScheduledTimeMs;
+}
+
 //==============================================================================
 void MainContentComponent::setLegacySourcePosition(source_index_t const sourceIndex,
                                                    radians_t const azimuth,
                                                    radians_t const elevation,
                                                    float const length,
                                                    float const newAzimuthSpan,
-                                                   float const newZenithSpan)
+                                                   float const newZenithSpan,
+                                                   tl::optional<juce::int64> const & scheduledTimeMs)
 {
-    ASSERT_OSC_THREAD;
-    juce::ScopedWriteLock const lock{ mLock };
+    jassert(isOscInputThread());
 
-    if (!mData.project.sources.contains(sourceIndex)) {
-        // There used to be an assert here, but by design we want to allow SpatGRIS to have more or less sources than
-        // ControlGRIS, to allow N number of ControlGRIS/controller instances to connect to M number of
-        // SpatGRIS/spatializer instances.
-        return;
-    }
+    SourcePositionMailboxes::Message const message{ SourcePositionMailboxes::Kind::legacy,
+                                                    { azimuth.get(), elevation.get(), length },
+                                                    newAzimuthSpan,
+                                                    newZenithSpan };
+    postSourcePosition(sourceIndex, message, scheduledTimeMs);
+    mSpatDataUpdater.wakeUp();
+}
 
-    auto const getCorrectedPosition = [&]() -> Position {
-        auto const & projectSpatMode{ mData.project.spatMode };
-        auto const spatMode{ projectSpatMode == SpatMode::hybrid ? mData.project.sources[sourceIndex].hybridSpatMode
-                                                                 : projectSpatMode };
+//==============================================================================
+void MainContentComponent::setSourcePosition(source_index_t const sourceIndex,
+                                             Position const position,
+                                             float const azimuthSpan,
+                                             float const zenithSpan,
+                                             tl::optional<juce::int64> const & scheduledTimeMs,
+                                             bool const shouldWakeUpSpatDataUpdater)
+{
+    jassert(isOscInputThread());
 
-        switch (spatMode) {
-        case SpatMode::vbap:
-            return Position{ PolarVector{ azimuth, elevation, 1.0f } };
+    // No lock here : the OSC thread only leaves the position in the source's mailbox. It is applied to the project
+    // by the spat data updater, once per batch.
+    auto const cartesian{ position.getCartesian() };
+    SourcePositionMailboxes::Message const message{ SourcePositionMailboxes::Kind::cartesian,
+                                                    { cartesian.x, cartesian.y, cartesian.z },
+                                                    std::clamp(azimuthSpan, 0.0f, 1.0f),
+                                                    std::clamp(zenithSpan, 0.0f, 1.0f) };
+    postSourcePosition(sourceIndex, message, scheduledTimeMs);
+    if (shouldWakeUpSpatDataUpdater) {
+        mSpatDataUpdater.wakeUp();
+    }
+}
 
-        case SpatMode::mbap:
-            return LegacyLbapPosition{ azimuth, elevation, length }.toPosition();
-        case SpatMode::hybrid:
-        case SpatMode::invalid:
-            break;
-        }
-        jassertfalse;
-        return {};
-    };
+//==============================================================================
+void MainContentComponent::wakeUpSpatDataUpdater() noexcept
+{
+    jassert(isOscInputThread());
+    mSpatDataUpdater.wakeUp();
+}
 
-    auto const correctedPosition{ getCorrectedPosition() };
-    auto & source{ mData.project.sources[sourceIndex] };
+//==============================================================================
+bool MainContentComponent::isOscInputThread() const noexcept
+{
+    return mOscInput != nullptr && mOscInput->isReceiverThread();
+}
 
-    if (correctedPosition == source.position && juce::approximatelyEqual(newAzimuthSpan, source.azimuthSpan)
-        && juce::approximatelyEqual(newZenithSpan, source.zenithSpan)) {
+//==============================================================================
+void MainContentComponent::postSourcePosition(source_index_t const sourceIndex,
+                                              SourcePositionMailboxes::Message const & message,
+                                              tl::optional<juce::int64> const & scheduledTimeMs)
+{
+    jassert(isOscInputThread());
+
+    if (scheduledTimeMs) {
+        if (mPositionSchedule.schedule({ *scheduledTimeMs, sourceIndex, message })) {
+            return;
+        }
+        // The schedule is full : better late than never.
+    } else if (mSourcePositionJitterBuffer.isEnabled()
+               && mSourcePositionJitterBuffer.push(sourceIndex, message, juce::Time::getMillisecondCounterHiRes())) {
         return;
     }
 
-    juce::ScopedWriteLock const writeLock{ mLock };
-
-    source.position = correctedPosition;
-    source.azimuthSpan = newAzimuthSpan;
-    source.zenithSpan = newZenithSpan;
-
-    updateSourceSpatData(sourceIndex);
+    mSourcePositionMailboxes.post(sourceIndex, message);
+    mSpatDataUpdater.markDirty(sourceIndex);
 }
 
 //==============================================================================
-void MainContentComponent::setSourcePosition(source_index_t const sourceIndex,
-                                             Position position,
-                                             float azimuthSpan,
-                                             float zenithSpan)
+void MainContentComponent::applySourcePositionMessage(source_index_t const sourceIndex,
+                                                      SourcePositionMailboxes::Message const & message)
 {
-    ASSERT_OSC_THREAD;
-
-    juce::ScopedWriteLock const lock{ getLock() };
+    jassert(!isProbablyAudioThread());
 
     if (!mData.project.sources.contains(sourceIndex)) {
         // There used to be an assert here, but by design we want to allow SpatGRIS to have more or less sources than
@@ -2069,34 +2192,50 @@ void MainContentComponent::setSourcePosition(source_index_t const sourceIndex,
 
     auto & source{ mData.project.sources[sourceIndex] };
 
-    azimuthSpan = std::clamp(azimuthSpan, 0.0f, 1.0f);
-    zenithSpan = std::clamp(zenithSpan, 0.0f, 1.0f);
-
     auto const & projectSpatMode{ mData.project.spatMode };
     auto const effectiveSpatMode{ projectSpatMode == SpatMode::hybrid ? source.hybridSpatMode : projectSpatMode };
-    switch (effectiveSpatMode) {
-    case SpatMode::vbap:
-        position = position.getPolar().normalized();
-        break;
-    case SpatMode::mbap:
-        position = position.getCartesian().clampedToFarField();
-        break;
-    case SpatMode::hybrid:
-    case SpatMode::invalid:
+
+    auto const getCorrectedPosition = [&]() -> Position {
+        auto const & coordinates{ message.coordinates };
+        if (message.kind == SourcePositionMailboxes::Kind::legacy) {
+            radians_t const azimuth{ coordinates[0] };
+            radians_t const elevation{ coordinates[1] };
+            switch (effectiveSpatMode) {
+            case SpatMode::vbap:
+                return Position{ PolarVector{ azimuth, elevation, 1.0f } };
+            case SpatMode::mbap:
+                return LegacyLbapPosition{ azimuth, elevation, coordinates[2] }.toPosition();
+            case SpatMode::hybrid:
+            case SpatMode::invalid:
+                break;
+            }
+            jassertfalse;
+            return {};
+        }
+
+        Position const position{ CartesianVector{ coordinates[0], coordinates[1], coordinates[2] } };
+        switch (effectiveSpatMode) {
+        case SpatMode::vbap:
+            return position.getPolar().normalized();
+        case SpatMode::mbap:
+            return position.getCartesian().clampedToFarField();
+        case SpatMode::hybrid:
+        case SpatMode::invalid:
+            break;
+        }
         jassertfalse;
-        break;
-    }
+        return position;
+    };
 
-    if (position == source.position && juce::approximatelyEqual(azimuthSpan, source.azimuthSpan)
-        && juce::approximatelyEqual(zenithSpan, source.zenithSpan)) {
+    auto const position{ getCorrectedPosition() };
+    if (position == source.position && juce::approximatelyEqual(message.azimuthSpan, source.azimuthSpan)
+        && juce::approximatelyEqual(message.zenithSpan, source.zenithSpan)) {
         return;
     }
 
     source.position = position;
-    source.azimuthSpan = azimuthSpan;
-    source.zenithSpan = zenithSpan;
-
-    updateSourceSpatData(sourceIndex);
+    source.azimuthSpan = message.azimuthSpan;
+    source.zenithSpan = message.zenithSpan;
 }
 
 //==============================================================================
@@ -2104,6 +2243,11 @@ void MainContentComponent::resetSourcePosition(source_index_t const sourceIndex)
 {
     juce::ScopedWriteLock const lock{ mLock };
 
+    // A position that arrived before the reset must not be applied after it.
+    mSourcePositionMailboxes.discard(sourceIndex);
+    mSourcePositionJitterBuffer.discard(sourceIndex);
+    mPositionSchedule.discard(sourceIndex);
+
     if (!mData.project.sources.contains(sourceIndex)) {
         // There used to be an assert here, but by design we want to allow SpatGRIS to have more or less sources than
         // ControlGRIS, to allow N number of ControlGRIS/controller instances to connect to M number of
@@ -2130,6 +2274,13 @@ void MainContentComponent::projectSourceIndexChanged(source_index_t oldSourceInd
 
     mData.project.ordering.sort();
 
+    // The positions received for either index belong to another source now.
+    for (auto const sourceIndex : { oldSourceIndex, newSourceIndex }) {
+        mSourcePositionMailboxes.discard(sourceIndex);
+        mSourcePositionJitterBuffer.discard(sourceIndex);
+        mPositionSchedule.discard(sourceIndex);
+    }
+
     refreshSourceSlices();
     refreshSpeakerSlices();
 }
@@ -2411,6 +2562,12 @@ void MainContentComponent::refreshAudioProcessor() const
         return;
     }
 
+    if (mSpatAlgorithmBuilder.isBuilding()) {
+        // The config has to reach the audio thread along with the algorithm it is meant for. This one is dropped on
+        // purpose : spatAlgorithmBuilt() calls this again once the build is over, with whatever mData holds by then.
+        return;
+    }
+
     mAudioProcessor->setAudioConfig(mData.toAudioConfig());
 }
 
@@ -2418,33 +2575,46 @@ void MainContentComponent::refreshAudioProcessor() const
 void MainContentComponent::refreshSpatAlgorithm()
 {
     JUCE_ASSERT_MESSAGE_THREAD;
-    juce::ScopedWriteLock const lock{ mLock };
+    juce::ScopedReadLock const lock{ mLock };
 
     if (!mAudioProcessor) {
         return;
     }
 
-    juce::ScopedLock const audioLock{ mAudioProcessor->getLock() };
+    // necessary to have the right preset at project initialization.
+    applyMulticoreDSPPreset();
 
-    auto & oldSpatAlgorithm{ mAudioProcessor->getSpatAlgorithm() };
+    SpatAlgorithmBuilder::Request request{ mData.speakerSetup,
+                                           mData.project.spatMode,
+                                           mData.appData.stereoMode,
+                                           mData.project.sources,
+                                           mData.appData.audioSettings.sampleRate,
+                                           mData.appData.audioSettings.bufferSize,
+                                           mData.project.useMulticoreDSP };
 
-    // AbstractSpatAlgorithm::make can make a hybrid mode algorithm with multicore dsp
-    // enable but this has been benchmarked to be less performant than single core.
-    const bool shouldUseMulticoreDSP = mData.project.useMulticoreDSP && mData.project.spatMode != SpatMode::hybrid;
+    if (mAudioProcessor->getSpatAlgorithm() == nullptr) {
+        // Nothing is playing yet and the initialization expects an algorithm to work with.
+        spatAlgorithmBuilt(SpatAlgorithmBuilder::build(request));
+        return;
+    }
 
-    // necessary to have the right preset at project initialization.
-    SpinSleepWait::setPerformancePreset(mData.project.multicoreDSPPreset);
+    mSpatAlgorithmBuilder.requestBuild(std::move(request));
+}
+
+//==============================================================================
+void MainContentComponent::spatAlgorithmBuilt(std::unique_ptr<AbstractSpatAlgorithm> newSpatAlgorithm)
+{
+    JUCE_ASSERT_MESSAGE_THREAD;
+    juce::ScopedWriteLock const lock{ mLock };
+
+    if (!mAudioProcessor) {
+        return;
+    }
 
-    auto newSpatAlgorithm{ AbstractSpatAlgorithm::make(mData.speakerSetup,
-                                                       mData.project.spatMode,
-                                                       mData.appData.stereoMode,
-                                                       mData.project.sources,
-                                                       mData.appData.audioSettings.sampleRate,
-                                                       mData.appData.audioSettings.bufferSize,
-                                                       shouldUseMulticoreDSP) };
+    auto const * oldSpatAlgorithm{ mAudioProcessor->getSpatAlgorithm() };
 
     if (newSpatAlgorithm->getError()
-        && (!oldSpatAlgorithm || oldSpatAlgorithm->getError() != newSpatAlgorithm->getError())) {
+        && (oldSpatAlgorithm == nullptr || oldSpatAlgorithm->getError() != newSpatAlgorithm->getError())) {
         switch (*newSpatAlgorithm->getError()) {
         case AbstractSpatAlgorithm::Error::notEnoughDomeSpeakers:
             juce::AlertWindow::showMessageBoxAsync(juce::AlertWindow::AlertIconType::InfoIcon,
@@ -2481,10 +2651,16 @@ void MainContentComponent::refreshSpatAlgorithm()
         }
     }
 
-    oldSpatAlgorithm = std::move(newSpatAlgorithm);
+    mAudioProcessor->setSpatAlgorithm(std::move(newSpatAlgorithm));
 
-    refreshAudioProcessor();
+    // The positions have to be in before the algorithm reaches the audio thread.
     reassignSourcesPositions();
+    refreshAudioProcessor();
+
+    if (!mAudioProcessor->getSpatAlgorithm()->hasTriplets()) {
+        mData.appData.viewSettings.showSpeakerTriplets = false;
+    }
+    refreshViewportConfig();
 }
 
 //==============================================================================
@@ -2710,10 +2886,14 @@ void MainContentComponent::removeSource(source_index_t const sourceIndex)
 {
     JUCE_ASSERT_MESSAGE_THREAD;
     juce::ScopedWriteLock const dataLock{ mLock };
-    juce::ScopedLock const audioLock{ mAudioProcessor->getLock() };
 
     mData.project.ordering.removeFirstMatchingValue(sourceIndex);
     mData.project.sources.remove(sourceIndex);
+
+    // Otherwise, they would move the source that gets this index next.
+    mSourcePositionMailboxes.discard(sourceIndex);
+    mSourcePositionJitterBuffer.discard(sourceIndex);
+    mPositionSchedule.discard(sourceIndex);
 }
 
 //==============================================================================
@@ -2846,7 +3026,6 @@ void MainContentComponent::removeSpeaker(output_patch_t const outputPatch, bool
 #endif
 
     juce::ScopedWriteLock const dataLock{ mLock };
-    juce::ScopedLock const audioLock{ mAudioProcessor->getLock() };
 
     mData.speakerSetup.ordering.removeFirstMatchingValue(outputPatch);
     mData.speakerSetup.speakers.remove(outputPatch);
@@ -2872,10 +3051,6 @@ void MainContentComponent::refreshSpeakers()
 
     refreshSpatAlgorithm();
 
-    if (!mAudioProcessor->getSpatAlgorithm()->hasTriplets()) {
-        mData.appData.viewSettings.showSpeakerTriplets = false;
-    }
-
     refreshSourceSlices();
     refreshSpeakerSlices();
     refreshViewportConfig();
@@ -3200,6 +3375,28 @@ void MainContentComponent::timerCallback()
 
     mInfoPanel->setCpuLoad(cpuRunningAverage);
 
+    // Percentiles need more than a few blocks to mean anything.
+    static constexpr juce::uint32 PROFILE_REFRESH_INTERVAL_MS = 1000;
+    auto const now{ juce::Time::getMillisecondCounter() };
+    if (mAudioProcessor && now - mLastProfileRefreshTime >= PROFILE_REFRESH_INTERVAL_MS) {
+        mLastProfileRefreshTime = now;
+        auto const stats{ mAudioProcessor->getProfiler().collectStats() };
+        mInfoPanel->setCallbackProfile(stats);
+        if (mData.project.useMulticoreDSP && mData.project.multicoreDSPPreset == MulticoreDSPTuner::AUTOMATIC_PRESET
+            && mMulticoreDSPTuner.update(stats)) {
+            applyMulticoreDSPPreset();
+            mControlPanel->setAutomaticMulticoreDSPPresetDescription(mMulticoreDSPTuner.getDescription());
+        }
+        mInfoPanel->setNumProcessedSources(mAudioProcessor->getNumProcessedSources(),
+                                           mAudioProcessor->getNumSources());
+    }
+
+    if (mAudioProcessor) {
+        auto & dropoutLedger{ mAudioProcessor->getDropoutLedger() };
+        dropoutLedger.collect();
+        mInfoPanel->setNumDropouts(dropoutLedger.getTotalCount());
+    }
+
     // TODO: could this be related to this issue https://github.com/GRIS-UdeM/SpatGRIS/issues/476 ?
     if (mIsProcessForeground != juce::Process::isForegroundProcess()) {
         mIsProcessForeground = juce::Process::isForegroundProcess();
@@ -28,17 +28,24 @@
 #include "sg_AudioProcessor.hpp"
 #include "sg_Configuration.hpp"
 #include "sg_ControlPanel.hpp"
+#include "sg_DropoutLedgerWindow.hpp"
 #include "sg_EditSpeakersWindow.hpp"
 #include "sg_FlatViewWindow.hpp"
 #include "sg_InfoPanel.hpp"
 #include "sg_LayoutComponent.hpp"
+#include "sg_MulticoreDSPTuner.hpp"
 #include "sg_OscInput.hpp"
 #include "sg_OscMonitor.hpp"
 #include "sg_PlayerWindow.hpp"
+#include "sg_PositionSchedule.hpp"
 #include "sg_PrepareToRecordWindow.hpp"
 #include "sg_SettingsWindow.hpp"
+#include "sg_SourcePositionJitterBuffer.hpp"
+#include "sg_SourcePositionMailboxes.hpp"
 #include "sg_SourceSliceComponent.hpp"
+#include "sg_SpatAlgorithmBuilder.hpp"
 #include "sg_SpatButton.hpp"
+#include "sg_SpatDataUpdater.hpp"
 #include "sg_SpeakerSliceComponent.hpp"
 #include "sg_SpeakerViewComponent.hpp"
 #include "sg_StereoSliceComponent.hpp"
@@ -79,6 +86,9 @@ class MainContentComponent final
     juce::ReadWriteLock mLock{};
 
     std::unique_ptr<AudioProcessor> mAudioProcessor{};
+    SpatAlgorithmBuilder mSpatAlgorithmBuilder{ [this](std::unique_ptr<AbstractSpatAlgorithm> spatAlgorithm) {
+        spatAlgorithmBuilt(std::move(spatAlgorithm));
+    } };
 
     OwnedMap<source_index_t, SourceSliceComponent, MAX_NUM_SOURCES> mSourceSliceComponents{};
     OwnedMap<output_patch_t, SpeakerSliceComponent, MAX_NUM_SPEAKERS> mSpeakerSliceComponents{};
@@ -93,6 +103,7 @@ class MainContentComponent final
     std::unique_ptr<AboutWindow> mAboutWindow{};
     std::unique_ptr<PrepareToRecordWindow> mPrepareToRecordWindow{};
     std::unique_ptr<OscMonitorWindow> mOscMonitorWindow{};
+    std::unique_ptr<DropoutLedgerWindow> mDropoutLedgerWindow{};
     std::unique_ptr<AddRemoveSourcesWindow> mAddRemoveSourcesWindow{};
     std::unique_ptr<PlayerWindow> mPlayerWindow{};
 
@@ -124,6 +135,8 @@ class MainContentComponent final
     bool mIsProcessForeground{ true };
     bool mIsLoadingSpeakerSetupOrProjectFile{ false };
     bool mSpeakerViewShouldGrabFocus{ false };
+    juce::uint32 mLastProfileRefreshTime{};
+    MulticoreDSPTuner mMulticoreDSPTuner{};
 
     GrisLookAndFeel & mLookAndFeel;
     SmallGrisLookAndFeel & mSmallLookAndFeel;
@@ -142,6 +155,16 @@ class MainContentComponent final
     // State
     SpatGrisData mData{};
     tl::optional<SpeakerSetup> mCurrentSpeakerSetupBeforeEditing{};
+    // Written by the OSC thread without locking, applied to mData by the SpatDataUpdater.
+    SourcePositionMailboxes mSourcePositionMailboxes{};
+    PositionSchedule mPositionSchedule{};
+    SourcePositionJitterBuffer mSourcePositionJitterBuffer{};
+    // SpatDataUpdater thread only.
+    juce::Array<source_index_t> mSpatDataBatch{};
+    // Declared after mData : its thread has to be stopped before the data goes away.
+    SpatDataUpdater mSpatDataUpdater{ [this](juce::Array<source_index_t> const & sources) {
+        return updateSourcesSpatData(sources);
+    } };
 
 public:
     //==============================================================================
@@ -158,13 +181,27 @@ public:
     auto const & getData() const noexcept { return mData; }
     auto const & getLock() const { return mLock; }
 
+    /** OSC thread : with a scheduled time (milliseconds since 1970), the position is only applied once it is due. */
     void setLegacySourcePosition(source_index_t sourceIndex,
                                  radians_t azimuth,
                                  radians_t elevation,
                                  float length,
                                  float newAzimuthSpan,
-                                 float newZenithSpan);
-    void setSourcePosition(source_index_t sourceIndex, Position position, float azimuthSpan, float zenithSpan);
+                                 float newZenithSpan,
+                                 tl::optional<juce::int64> const & scheduledTimeMs);
+    /** OSC thread : with a scheduled time (milliseconds since 1970), the position is only applied once it is due.
+     *
+     * The positions of a batch are posted without waking the spat data updater up, which is done once for the whole
+     * batch with wakeUpSpatDataUpdater().
+     */
+    void setSourcePosition(source_index_t sourceIndex,
+                           Position position,
+                           float azimuthSpan,
+                           float zenithSpan,
+                           tl::optional<juce::int64> const & scheduledTimeMs,
+                           bool shouldWakeUpSpatDataUpdater = true);
+    /** OSC thread : the positions posted since the last call are applied with the next update. */
+    void wakeUpSpatDataUpdater() noexcept;
 
     void resetSourcePosition(source_index_t sourceIndex);
     void projectSourceIndexChanged(source_index_t oldSourceIndex, source_index_t newSourceIndex);
@@ -228,6 +265,8 @@ public:
     void setSpatMode(SpatMode const spatMode);
     void setMulticoreDSPState(bool const state);
     void setMulticoreDSPPreset(int preset);
+    /** Hands the preset of the project, or the one picked by the tuner, to the multicore DSP workers. */
+    void applyMulticoreDSPPreset();
     void setStereoMode(tl::optional<StereoMode> stereoMode);
     void setStereoRouting(StereoRouting const & routing);
     void cubeAttenuationDbChanged(dbfs_t value);
@@ -236,6 +275,9 @@ public:
     void numSourcesChanged(int numSources);
     void masterGainChanged(dbfs_t gain);
     void interpolationChanged(float interpolation);
+    void jitterBufferDelayChanged(int delayMs);
+    /** Whether the silent sources are kept out of the spatialization. */
+    void setSourceGating(bool isEnabled);
     void generalMuteButtonPressed();
     void recordButtonPressed();
 
@@ -291,6 +333,7 @@ public:
     //==============================================================================
     // Commands.
     void handleShowPreferences();
+    void handleShowDropoutLedgerWindow();
     void saveAsEditedSpeakerSetup();
     void saveEditedSpeakerSetup();
 
@@ -302,6 +345,7 @@ public:
     void closeAboutWindow() { mAboutWindow.reset(); }
     void closePlayerWindow();
     void closeOscMonitorWindow() { mOscMonitorWindow.reset(); }
+    void closeDropoutLedgerWindow() { mDropoutLedgerWindow.reset(); }
     void closePrepareToRecordWindow() { mPrepareToRecordWindow.reset(); }
     void closeAddRemoveSourcesWindow() { mAddRemoveSourcesWindow.reset(); }
 
@@ -373,9 +417,24 @@ private:
     void refreshSpeakerSlices();
 
     void updateSourceSpatData(source_index_t sourceIndex);
-
+    /** Called by the SpatDataUpdater with the sources that moved since its last batch. Returns when it has to be
+     * called again, for the scheduled positions and the smoothed ones.
+     */
+    tl::optional<juce::int64> updateSourcesSpatData(juce::Array<source_index_t> const & sources);
+    [[nodiscard]] bool isOscInputThread() const noexcept;
+    /** Does not wake the spat data updater up : the caller does, once it has posted all of its positions. */
+    void postSourcePosition(source_index_t sourceIndex,
+                            SourcePositionMailboxes::Message const & message,
+                            tl::optional<juce::int64> const & scheduledTimeMs);
+    /** Must be called with the write lock. */
+    void applySourcePositionMessage(source_index_t sourceIndex, SourcePositionMailboxes::Message const & message);
+
+    /** Publishes the current config to the audio thread. Does nothing while an algorithm is being built :
+     * spatAlgorithmBuilt() publishes it along with the new algorithm once the build is over. */
     void refreshAudioProcessor() const;
+    /** Rebuilds the spatialization algorithm in the background. The current one keeps playing until it is done. */
     void refreshSpatAlgorithm();
+    void spatAlgorithmBuilt(std::unique_ptr<AbstractSpatAlgorithm> newSpatAlgorithm);
     void updatePeaks();
     void reassignSourcesPositions();
     //==============================================================================
@@ -0,0 +1,82 @@
+/*
+ This file is part of SpatGRIS.
+
+ Developers: Gaël Lane Lépine, Samuel Béland, Olivier Bélanger, Nicolas Masson
+
+ SpatGRIS is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ SpatGRIS is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with SpatGRIS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sg_MulticoreDSPTuner.hpp"
+
+#include "Data/sg_constants.hpp"
+
+namespace gris
+{
+//==============================================================================
+MulticoreDSPTuner::MulticoreDSPTuner()
+    : mPreset(OPTIMIZE_CPU_MULTICORE_PRESET)
+    , mCanSpin(juce::SystemStats::getNumCpus() > 1)
+{
+}
+
+//==============================================================================
+tl::optional<int> MulticoreDSPTuner::update(CallbackProfiler::Stats const & stats) noexcept
+{
+    auto const & total{ stats[static_cast<size_t>(CallbackProfiler::Stage::total)] };
+    if (total.numBlocks == 0 || !mCanSpin) {
+        return tl::nullopt;
+    }
+
+    if (total.p99 >= SPIN_ABOVE_LOAD) {
+        mNumCalmUpdates = 0;
+        if (mPreset != OPTIMIZE_LATENCY_MULTICORE_PRESET) {
+            mPreset = OPTIMIZE_LATENCY_MULTICORE_PRESET;
+            return mPreset;
+        }
+        return tl::nullopt;
+    }
+
+    if (mPreset == OPTIMIZE_CPU_MULTICORE_PRESET) {
+        return tl::nullopt;
+    }
+
+    mNumCalmUpdates = total.p99 < SLEEP_BELOW_LOAD ? mNumCalmUpdates + 1 : 0;
+    if (mNumCalmUpdates < NUM_CALM_UPDATES_BEFORE_SLEEPING) {
+        return tl::nullopt;
+    }
+    mNumCalmUpdates = 0;
+    mPreset = OPTIMIZE_CPU_MULTICORE_PRESET;
+    return mPreset;
+}
+
+//==============================================================================
+void MulticoreDSPTuner::reset() noexcept
+{
+    mPreset = OPTIMIZE_CPU_MULTICORE_PRESET;
+    mNumCalmUpdates = 0;
+}
+
+//==============================================================================
+juce::String MulticoreDSPTuner::getDescription() const
+{
+    if (!mCanSpin) {
+        return "Always A : spinning workers would compete with the audio callback for the only core.";
+    }
+    if (mPreset == OPTIMIZE_LATENCY_MULTICORE_PRESET) {
+        return "Currently B : the audio callback is close to its deadline.";
+    }
+    return "Currently A : the audio callback has enough slack.";
+}
+
+} // namespace gris
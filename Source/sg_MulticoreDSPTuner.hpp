@@ -0,0 +1,72 @@
+/*
+ This file is part of SpatGRIS.
+
+ Developers: Gaël Lane Lépine, Samuel Béland, Olivier Bélanger, Nicolas Masson
+
+ SpatGRIS is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ SpatGRIS is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with SpatGRIS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "sg_CallbackProfiler.hpp"
+#include "tl/optional.hpp"
+
+namespace gris
+{
+//==============================================================================
+/** Picks the waiting policy of the multicore DSP workers from how close the audio callback gets to its deadline.
+ *
+ * Spinning workers wake up faster but burn CPU, sleeping workers are the other way around. While there is plenty of
+ * slack, the workers can afford to sleep. When the callback gets close to its deadline, the wake-up latency starts to
+ * matter and the workers spin. The tuner switches back only after a few calm periods, so that it does not flip-flop
+ * around the threshold.
+ *
+ * On a single core, a spinning worker holds the core until the scheduler takes it away, which delays the job by whole
+ * time slices (see the --handoff benchmark) : the tuner then always lets the workers sleep.
+ */
+class MulticoreDSPTuner
+{
+public:
+    /** Stored in the project in place of a preset when the tuner picks it. */
+    static constexpr auto AUTOMATIC_PRESET = -1;
+
+private:
+    // Share of the block deadline used by the whole callback (p99).
+    static constexpr auto SPIN_ABOVE_LOAD = 0.6f;
+    static constexpr auto SLEEP_BELOW_LOAD = 0.3f;
+    static constexpr auto NUM_CALM_UPDATES_BEFORE_SLEEPING = 5;
+
+    int mPreset;
+    int mNumCalmUpdates{};
+    bool mCanSpin;
+
+public:
+    //==============================================================================
+    MulticoreDSPTuner();
+    ~MulticoreDSPTuner() = default;
+    SG_DELETE_COPY_AND_MOVE(MulticoreDSPTuner)
+    //==============================================================================
+    /** Returns the new preset if it changed. */
+    [[nodiscard]] tl::optional<int> update(CallbackProfiler::Stats const & stats) noexcept;
+    /** Starts over from the preset that uses the least CPU. */
+    void reset() noexcept;
+    [[nodiscard]] int getPreset() const noexcept { return mPreset; }
+    [[nodiscard]] juce::String getDescription() const;
+
+private:
+    //==============================================================================
+    JUCE_LEAK_DETECTOR(MulticoreDSPTuner)
+};
+
+} // namespace gris
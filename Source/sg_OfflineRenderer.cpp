@@ -0,0 +1,457 @@
+/*
+ This file is part of SpatGRIS.
+
+ Developers: Gaël Lane Lépine, Samuel Béland, Olivier Bélanger, Nicolas Masson
+
+ SpatGRIS is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ SpatGRIS is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with SpatGRIS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sg_OfflineRenderer.hpp"
+
+#include "sg_AudioProcessor.hpp"
+#include "sg_MulticoreDSPTuner.hpp"
+#include "sg_ParallelSpatAlgorithm.hpp"
+#include "sg_SpatAlgorithmBuilder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <iostream>
+
+namespace gris
+{
+namespace
+{
+constexpr auto RENDER_OPTION = "--render";
+
+//==============================================================================
+void printUsage()
+{
+    std::cerr << "Usage : SpatGRIS --render --project <file> --speakers <file> --sources <folder> --output <folder>\n"
+                 "                 [--automation <file>] [--buffer-size <samples>]"
+              << std::endl;
+}
+
+//==============================================================================
+juce::File getFileForOption(juce::ArgumentList const & args, juce::String const & option)
+{
+    auto const value{ args.getValueForOption(option) };
+    if (value.isEmpty()) {
+        return juce::File{};
+    }
+    return juce::File::getCurrentWorkingDirectory().getChildFile(value.unquoted());
+}
+
+} // namespace
+
+//==============================================================================
+OfflineRenderer::OfflineRenderer(Options options) : mOptions(std::move(options))
+{
+    mFormatManager.registerBasicFormats();
+}
+
+//==============================================================================
+int OfflineRenderer::run()
+{
+    JUCE_ASSERT_MESSAGE_THREAD;
+
+    using Step = juce::Result (OfflineRenderer::*)();
+    // The speaker setup has to be loaded first : the project falls back to its spatialization mode.
+    static constexpr std::array<Step, 5> STEPS{ &OfflineRenderer::loadSpeakerSetup,
+                                                &OfflineRenderer::loadProject,
+                                                &OfflineRenderer::loadSources,
+                                                &OfflineRenderer::loadAutomation,
+                                                &OfflineRenderer::render };
+
+    for (auto const step : STEPS) {
+        auto const result{ (this->*step)() };
+        if (result.failed()) {
+            std::cerr << "Error : " << result.getErrorMessage() << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+//==============================================================================
+bool OfflineRenderer::isRenderCommandLine(juce::String const & commandLine)
+{
+    return juce::StringArray::fromTokens(commandLine, true).contains(RENDER_OPTION);
+}
+
+//==============================================================================
+tl::optional<OfflineRenderer::Options> OfflineRenderer::parseCommandLine(juce::String const & commandLine)
+{
+    juce::ArgumentList const args{ "SpatGRIS", commandLine };
+    jassert(args.containsOption(RENDER_OPTION));
+
+    Options options{};
+    options.projectFile = getFileForOption(args, "--project");
+    options.speakerSetupFile = getFileForOption(args, "--speakers");
+    options.sourcesFolder = getFileForOption(args, "--sources");
+    options.automationFile = getFileForOption(args, "--automation");
+    options.outputFolder = getFileForOption(args, "--output");
+    if (args.containsOption("--buffer-size")) {
+        options.bufferSize = args.getValueForOption("--buffer-size").getIntValue();
+    }
+
+    if (options.projectFile == juce::File{} || options.speakerSetupFile == juce::File{}
+        || options.sourcesFolder == juce::File{} || options.outputFolder == juce::File{}) {
+        printUsage();
+        return tl::nullopt;
+    }
+    if (options.bufferSize <= 0 || options.bufferSize > SpeakerAudioBuffer::MAX_NUM_SAMPLES) {
+        std::cerr << "Error : the buffer size has to be between 1 and " << SpeakerAudioBuffer::MAX_NUM_SAMPLES
+                  << " samples." << std::endl;
+        return tl::nullopt;
+    }
+
+    return options;
+}
+
+//==============================================================================
+juce::Result OfflineRenderer::loadSpeakerSetup()
+{
+    juce::XmlDocument xmlDoc{ mOptions.speakerSetupFile };
+    auto const mainXmlElem{ xmlDoc.getDocumentElement() };
+    if (!mainXmlElem) {
+        return juce::Result::fail("File \"" + mOptions.speakerSetupFile.getFullPathName() + "\" is corrupted.\n"
+                                  + xmlDoc.getLastParseError());
+    }
+
+    auto speakerSetup{ SpeakerSetup::fromXml(*mainXmlElem) };
+    if (!speakerSetup) {
+        return juce::Result::fail("File \"" + mOptions.speakerSetupFile.getFullPathName()
+                                  + "\" is not a valid speaker setup.");
+    }
+
+    mData.speakerSetup = std::move(*speakerSetup);
+    return juce::Result::ok();
+}
+
+//==============================================================================
+juce::Result OfflineRenderer::loadProject()
+{
+    juce::XmlDocument xmlDoc{ mOptions.projectFile };
+    auto const mainXmlElem{ xmlDoc.getDocumentElement() };
+    if (!mainXmlElem) {
+        return juce::Result::fail("File \"" + mOptions.projectFile.getFullPathName() + "\" is corrupted.\n"
+                                  + xmlDoc.getLastParseError());
+    }
+
+    auto projectData{ ProjectData::fromXml(*mainXmlElem) };
+    if (!projectData) {
+        return juce::Result::fail("File \"" + mOptions.projectFile.getFullPathName()
+                                  + "\" is not a valid project, or was made with a newer version of SpatGRIS.");
+    }
+
+    mData.project = std::move(*projectData);
+
+    // for project prior to SG 3.1.8 (hybrid is redirected to vbap)
+    if (mData.project.spatMode == SpatMode::invalid) {
+        mData.project.spatMode = mData.speakerSetup.spatMode;
+    }
+
+    // There is no stereo reduction when rendering : every speaker gets its own file.
+    mData.appData.stereoMode = tl::nullopt;
+    return juce::Result::ok();
+}
+
+//==============================================================================
+juce::Result OfflineRenderer::loadSources()
+{
+    if (!mOptions.sourcesFolder.isDirectory()) {
+        return juce::Result::fail("Folder \"" + mOptions.sourcesFolder.getFullPathName() + "\" does not exist.");
+    }
+
+    auto const files{ mOptions.sourcesFolder.findChildFiles(juce::File::TypesOfFileToFind::findFiles,
+                                                            false,
+                                                            "*.wav;*.aif;*.aiff") };
+    for (auto const & file : files) {
+        std::unique_ptr<juce::AudioFormatReader> reader{ mFormatManager.createReaderFor(file) };
+        if (!reader) {
+            return juce::Result::fail("Unable to read \"" + file.getFullPathName() + "\".");
+        }
+
+        // same naming as the player
+        auto const channel{
+            file.getFileNameWithoutExtension().fromLastOccurrenceOf(juce::String("-"), false, true).getIntValue()
+        };
+        source_index_t const sourceIndex{ channel };
+        if (channel < source_index_t::OFFSET || !mData.project.sources.contains(sourceIndex)) {
+            std::cout << "Skipping \"" << file.getFileName() << "\" : the project has no matching source."
+                      << std::endl;
+            continue;
+        }
+
+        if (mSampleRate == 0.0) {
+            mSampleRate = reader->sampleRate;
+        } else if (!juce::approximatelyEqual(reader->sampleRate, mSampleRate)) {
+            return juce::Result::fail("\"" + file.getFullPathName() + "\" is at " + juce::String{ reader->sampleRate }
+                                      + " Hz while the other files are at " + juce::String{ mSampleRate } + " Hz.");
+        }
+
+        // Shorter files are padded with silence.
+        mLengthInSamples = std::max(mLengthInSamples, reader->lengthInSamples);
+        mSourceFiles.push_back(SourceFile{ sourceIndex, std::move(reader) });
+    }
+
+    if (mSourceFiles.empty()) {
+        return juce::Result::fail("No audio file in \"" + mOptions.sourcesFolder.getFullPathName()
+                                  + "\" matches a source of the project.");
+    }
+
+    mData.appData.audioSettings.sampleRate = mSampleRate;
+    mData.appData.audioSettings.bufferSize = mOptions.bufferSize;
+    return juce::Result::ok();
+}
+
+//==============================================================================
+juce::Result OfflineRenderer::loadAutomation()
+{
+    if (mOptions.automationFile == juce::File{}) {
+        return juce::Result::ok();
+    }
+    if (!mOptions.automationFile.existsAsFile()) {
+        return juce::Result::fail("File \"" + mOptions.automationFile.getFullPathName() + "\" does not exist.");
+    }
+
+    juce::StringArray lines{};
+    mOptions.automationFile.readLines(lines);
+
+    for (int lineIndex{}; lineIndex < lines.size(); ++lineIndex) {
+        auto const line{ lines[lineIndex].trim() };
+        if (line.isEmpty() || line.startsWithChar('#')) {
+            continue;
+        }
+
+        auto const fail = [&]() {
+            return juce::Result::fail("Line " + juce::String{ lineIndex + 1 } + " of \""
+                                      + mOptions.automationFile.getFullPathName() + "\" is invalid : " + line);
+        };
+
+        auto tokens{ juce::StringArray::fromTokens(line, ",", "") };
+        tokens.trim();
+        if (tokens.size() != 6 && tokens.size() != 8) {
+            return fail();
+        }
+
+        source_index_t const sourceIndex{ tokens[1].getIntValue() };
+        if (!LEGAL_SOURCE_INDEX_RANGE.contains(sourceIndex)) {
+            return fail();
+        }
+
+        AutomationEvent event{};
+        event.time = tokens[0].getDoubleValue();
+        event.sourceIndex = sourceIndex;
+        if (tokens.size() == 8) {
+            event.azimuthSpan = tokens[6].getFloatValue();
+            event.zenithSpan = tokens[7].getFloatValue();
+        }
+
+        auto const & coordinateType{ tokens[2] };
+        auto const a{ tokens[3].getFloatValue() };
+        auto const b{ tokens[4].getFloatValue() };
+        auto const c{ tokens[5].getFloatValue() };
+        if (coordinateType == "pol") {
+            auto const azimuth{ HALF_PI - radians_t{ a } };
+            radians_t const zenith{ b };
+            event.position = Position{ PolarVector{ azimuth.balanced(), zenith.balanced(), c } };
+        } else if (coordinateType == "deg") {
+            auto const azimuth{ HALF_PI - radians_t{ degrees_t{ a } } };
+            radians_t const zenith{ degrees_t{ b } };
+            event.position = Position{ PolarVector{ azimuth.balanced(), zenith.balanced(), c } };
+        } else if (coordinateType == "car") {
+            event.position = Position{ CartesianVector{ a, b, c } };
+        } else {
+            return fail();
+        }
+
+        mAutomation.push_back(event);
+    }
+
+    std::stable_sort(mAutomation.begin(), mAutomation.end(), [](AutomationEvent const & a, AutomationEvent const & b) {
+        return a.time < b.time;
+    });
+
+    return juce::Result::ok();
+}
+
+//==============================================================================
+void OfflineRenderer::applyAutomationEvent(AutomationEvent const & event, AbstractSpatAlgorithm & spatAlgorithm)
+{
+    if (!mData.project.sources.contains(event.sourceIndex)) {
+        return;
+    }
+
+    auto & source{ mData.project.sources[event.sourceIndex] };
+
+    // Same as MainContentComponent::setSourcePosition()
+    auto const & projectSpatMode{ mData.project.spatMode };
+    auto const effectiveSpatMode{ projectSpatMode == SpatMode::hybrid ? source.hybridSpatMode : projectSpatMode };
+    switch (effectiveSpatMode) {
+    case SpatMode::vbap:
+        source.position = event.position.getPolar().normalized();
+        break;
+    case SpatMode::mbap:
+        source.position = event.position.getCartesian().clampedToFarField();
+        break;
+    case SpatMode::hybrid:
+    case SpatMode::invalid:
+        jassertfalse;
+        return;
+    }
+    source.azimuthSpan = std::clamp(event.azimuthSpan, 0.0f, 1.0f);
+    source.zenithSpan = std::clamp(event.zenithSpan, 0.0f, 1.0f);
+
+    spatAlgorithm.updateSpatData(event.sourceIndex, source);
+}
+
+//==============================================================================
+juce::Result OfflineRenderer::render()
+{
+    auto const bufferSize{ mOptions.bufferSize };
+
+    // Blocks are rendered back to back, as if every one of them was right at its deadline : the tuner would have the
+    // workers spin.
+    auto const preset{ mData.project.multicoreDSPPreset };
+    auto const isAutomatic{ preset == MulticoreDSPTuner::AUTOMATIC_PRESET };
+    SpinSleepWait::setPerformancePreset(isAutomatic ? OPTIMIZE_LATENCY_MULTICORE_PRESET : preset);
+
+    // Same algorithm as MainContentComponent::refreshSpatAlgorithm() : the builder picks the hybrid one.
+    auto spatAlgorithm{ SpatAlgorithmBuilder::build({ mData.speakerSetup,
+                                                      mData.project.spatMode,
+                                                      tl::nullopt,
+                                                      mData.project.sources,
+                                                      mSampleRate,
+                                                      bufferSize,
+                                                      mData.project.useMulticoreDSP }) };
+    if (!spatAlgorithm || spatAlgorithm->getError()) {
+        return juce::Result::fail("The speaker setup cannot be used with the spatialization mode of the project.");
+    }
+    for (auto const source : mData.project.sources) {
+        spatAlgorithm->updateSpatData(source.key, *source.value);
+    }
+
+    AudioProcessor audioProcessor{};
+    audioProcessor.setBufferSize(bufferSize);
+    audioProcessor.setSpatAlgorithm(std::move(spatAlgorithm));
+    auto audioConfig{ mData.toAudioConfig() };
+    auto const sources{ audioConfig->sourcesAudioConfig.getKeys() };
+    auto const speakers{ audioConfig->speakersAudioConfig.getKeys() };
+    audioProcessor.setAudioConfig(std::move(audioConfig));
+
+    // Plays the part of the audio thread.
+    std::unique_ptr<SourceAudioBuffer> inputBuffer{};
+    std::unique_ptr<SpeakerAudioBuffer> outputBuffer{};
+    // Only used to render straight into the outputs of an audio device.
+    std::unique_ptr<SpeakerAudioBuffer> deviceOutputBuffer{};
+    audioProcessor.updateAudioConfig(inputBuffer, outputBuffer, deviceOutputBuffer);
+    jassert(inputBuffer && outputBuffer);
+    juce::AudioBuffer<float> stereoBuffer{ 2, bufferSize };
+    auto & renderedSpatAlgorithm{ *audioProcessor.getSpatAlgorithm() };
+
+    if (!mOptions.outputFolder.createDirectory()) {
+        return juce::Result::fail("Unable to create \"" + mOptions.outputFolder.getFullPathName() + "\".");
+    }
+
+    juce::WavAudioFormat wavFormat{};
+    std::vector<std::unique_ptr<juce::AudioFormatWriter>> writers{};
+    auto const baseName{ mOptions.projectFile.getFileNameWithoutExtension() };
+    for (auto const outputPatch : speakers) {
+        auto const outputFile{ mOptions.outputFolder.getChildFile(baseName + "-" + juce::String{ outputPatch.get() }
+                                                                  + ".wav") };
+        outputFile.deleteFile();
+        std::unique_ptr<juce::OutputStream> outputStream{ outputFile.createOutputStream() };
+        if (!outputStream) {
+            return juce::Result::fail("Unable to write to \"" + outputFile.getFullPathName() + "\".");
+        }
+        auto writer{ wavFormat.createWriterFor(outputStream,
+                                               juce::AudioFormatWriterOptions{}
+                                                   .withSampleRate(mSampleRate)
+                                                   .withNumChannels(1)
+                                                   .withBitsPerSample(BITS_PER_SAMPLE)) };
+        if (!writer) {
+            return juce::Result::fail("Unable to write to \"" + outputFile.getFullPathName() + "\".");
+        }
+        writers.push_back(std::move(writer));
+    }
+
+    std::cout << "Rendering " << mSourceFiles.size() << " sources to " << speakers.size() << " speakers ("
+              << juce::String{ static_cast<double>(mLengthInSamples) / mSampleRate, 2 } << " s)..." << std::endl;
+
+    // The profiler measures the stages against the duration of a block.
+    audioProcessor.getProfiler().startBlock(bufferSize, mSampleRate);
+
+    auto const startTicks{ juce::Time::getHighResolutionTicks() };
+    auto nextEvent{ mAutomation.cbegin() };
+    auto const getEventSample = [&](AutomationEvent const & event) {
+        return static_cast<juce::int64>(std::llround(event.time * mSampleRate));
+    };
+    for (juce::int64 blockStart{}; blockStart < mLengthInSamples; blockStart += bufferSize) {
+        auto const numSamples{ static_cast<int>(std::min<juce::int64>(bufferSize, mLengthInSamples - blockStart)) };
+
+        // Events split their block : each one is applied at its exact sample, and the gains ramp from there.
+        for (int segmentStart{}; segmentStart < numSamples;) {
+            for (; nextEvent != mAutomation.cend() && getEventSample(*nextEvent) <= blockStart + segmentStart;
+                 ++nextEvent) {
+                applyAutomationEvent(*nextEvent, renderedSpatAlgorithm);
+            }
+            auto segmentEnd{ numSamples };
+            if (nextEvent != mAutomation.cend()) {
+                auto const eventOffset{ getEventSample(*nextEvent) - blockStart };
+                segmentEnd = static_cast<int>(std::min<juce::int64>(numSamples, eventOffset));
+            }
+            auto const segmentSize{ segmentEnd - segmentStart };
+
+            inputBuffer->setNumSamples(segmentSize);
+            outputBuffer->setNumSamples(segmentSize);
+            stereoBuffer.setSize(2, segmentSize, false, false, true);
+            inputBuffer->silence();
+            outputBuffer->silence();
+            stereoBuffer.clear();
+            for (auto const & sourceFile : mSourceFiles) {
+                if (!sources.contains(sourceFile.sourceIndex)) {
+                    continue;
+                }
+                auto * const destination{ (*inputBuffer)[sourceFile.sourceIndex].getWritePointer(0) };
+                sourceFile.reader->read(&destination, 1, blockStart + segmentStart, segmentSize);
+            }
+
+            audioProcessor.processAudio(*inputBuffer, *outputBuffer, stereoBuffer, mSampleRate);
+
+            for (size_t i{}; i < writers.size(); ++i) {
+                auto const * const data{ (*outputBuffer)[speakers[static_cast<int>(i)]].getReadPointer(0) };
+                if (!writers[i]->writeFromFloatArrays(&data, 1, segmentSize)) {
+                    return juce::Result::fail("Unable to write to \"" + mOptions.outputFolder.getFullPathName()
+                                              + "\".");
+                }
+            }
+            segmentStart = segmentEnd;
+        }
+    }
+
+    // Flushes the files.
+    writers.clear();
+
+    auto const elapsed{ juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks) };
+    auto const duration{ static_cast<double>(mLengthInSamples) / mSampleRate };
+    std::cout << "Done in " << juce::String{ elapsed, 2 } << " s ("
+              << juce::String{ duration / std::max(elapsed, 1e-9), 1 } << "x real time)." << std::endl;
+
+    return juce::Result::ok();
+}
+
+} // namespace gris
@@ -0,0 +1,111 @@
+/*
+ This file is part of SpatGRIS.
+
+ Developers: Gaël Lane Lépine, Samuel Béland, Olivier Bélanger, Nicolas Masson
+
+ SpatGRIS is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ SpatGRIS is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with SpatGRIS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Data/sg_LogicStrucs.hpp"
+#include "Data/sg_Macros.hpp"
+
+#include <JuceHeader.h>
+
+namespace gris
+{
+class AbstractSpatAlgorithm;
+
+//==============================================================================
+/** Renders a project to one file per speaker, without an audio device and as fast as the CPU allows.
+ *
+ * Started from the command line with :
+ *
+ *   SpatGRIS --render --project <file> --speakers <file> --sources <folder> --output <folder>
+ *            [--automation <file>] [--buffer-size <samples>]
+ *
+ * The sources folder follows the same naming as the player : the source index comes after the last "-" of each file
+ * name. The automation file holds one position per line :
+ *
+ *   <seconds>,<source index>,<pol|deg|car>,<a>,<b>,<c>[,<azimuth span>,<zenith span>]
+ *
+ * where a, b and c are the azimuth, elevation and radius (or x, y and z) as they would be sent over OSC. Positions are
+ * applied at the exact sample of their timestamp : the block that contains it is rendered in two parts, so that the
+ * gains of the second part ramp from there. Two renders of the same automation are identical.
+ */
+class OfflineRenderer
+{
+    static constexpr auto DEFAULT_BUFFER_SIZE = 512;
+    static constexpr auto BITS_PER_SAMPLE = 24;
+
+public:
+    struct Options {
+        juce::File projectFile{};
+        juce::File speakerSetupFile{};
+        juce::File sourcesFolder{};
+        juce::File automationFile{};
+        juce::File outputFolder{};
+        int bufferSize{ DEFAULT_BUFFER_SIZE };
+    };
+
+private:
+    struct AutomationEvent {
+        double time{};
+        source_index_t sourceIndex{};
+        Position position{};
+        float azimuthSpan{};
+        float zenithSpan{};
+    };
+
+    struct SourceFile {
+        source_index_t sourceIndex{};
+        std::unique_ptr<juce::AudioFormatReader> reader{};
+    };
+
+    Options mOptions{};
+    SpatGrisData mData{};
+    juce::AudioFormatManager mFormatManager{};
+    std::vector<SourceFile> mSourceFiles{};
+    std::vector<AutomationEvent> mAutomation{};
+    double mSampleRate{};
+    juce::int64 mLengthInSamples{};
+
+public:
+    //==============================================================================
+    explicit OfflineRenderer(Options options);
+    OfflineRenderer() = delete;
+    ~OfflineRenderer() = default;
+    SG_DELETE_COPY_AND_MOVE(OfflineRenderer)
+    //==============================================================================
+    /** Loads everything, renders and writes the speaker files. Returns the process exit code. */
+    [[nodiscard]] int run();
+    //==============================================================================
+    [[nodiscard]] static bool isRenderCommandLine(juce::String const & commandLine);
+    /** Returns nullopt and prints the usage if the arguments are incomplete. */
+    [[nodiscard]] static tl::optional<Options> parseCommandLine(juce::String const & commandLine);
+
+private:
+    //==============================================================================
+    [[nodiscard]] juce::Result loadProject();
+    [[nodiscard]] juce::Result loadSpeakerSetup();
+    [[nodiscard]] juce::Result loadSources();
+    [[nodiscard]] juce::Result loadAutomation();
+    [[nodiscard]] juce::Result render();
+    void applyAutomationEvent(AutomationEvent const & event, AbstractSpatAlgorithm & spatAlgorithm);
+    //==============================================================================
+    JUCE_LEAK_DETECTOR(OfflineRenderer)
+};
+
+} // namespace gris
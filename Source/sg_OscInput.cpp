@@ -21,68 +21,147 @@
 
 #include "sg_MainComponent.hpp"
 
+#include <cstring>
+
 namespace gris
 {
 namespace
 {
-// see juce::OSCTypes
-constexpr auto INT_TAG = 'i';
-constexpr auto FLOAT_TAG = 'f';
-constexpr auto STRING_TAG = 's';
+constexpr std::string_view SPAT_GRIS_OSC_ADDRESS{ "/spat/serv" };
+
+// The blob of a "batch" message : a header, then one entry per source. See README.md.
+constexpr int BATCH_HEADER_SIZE = 4;
+constexpr int BATCH_ENTRY_HEADER_SIZE = 4;
+constexpr int BATCH_NUM_VALUES = 5;
+constexpr std::uint8_t BATCH_FLOAT32_ENCODING = 0;
+constexpr std::uint8_t BATCH_INT16_ENCODING = 1;
+constexpr std::uint8_t BATCH_POLAR_RADIAN = 0;
+constexpr std::uint8_t BATCH_POLAR_DEGREE = 1;
+constexpr std::uint8_t BATCH_CARTESIAN = 2;
 
-auto constexpr IS_INT = [](juce::OSCArgument const & arg) -> bool { return arg.getType() == INT_TAG; };
-auto constexpr IS_FLOAT = [](juce::OSCArgument const & arg) -> bool { return arg.getType() == FLOAT_TAG; };
-auto constexpr IS_STRING = [](juce::OSCArgument const & arg) -> bool { return arg.getType() == STRING_TAG; };
+auto constexpr IS_FLOAT = [](OscArgumentView const & arg) -> bool { return arg.isFloat32(); };
 
-juce::String const SPAT_GRIS_OSC_ADDRESS = "/spat/serv";
+//==============================================================================
+/** The first argument of a "/spat/serv" message. */
+enum class Command { unknown, polarRadian, polarDegree, cartesian, batch, clear, hybridMode, legacyReset, colour };
 
 //==============================================================================
-juce::String argumentToString(juce::OSCArgument const & argument) noexcept
+Command getCommand(std::string_view const string) noexcept
 {
-    if (IS_FLOAT(argument)) {
-        return juce::String{ argument.getFloat32() };
-    }
-    if (IS_INT(argument)) {
-        return juce::String{ argument.getInt32() };
-    }
-    if (IS_STRING(argument)) {
-        return argument.getString();
+    // The hash only narrows it down to one candidate.
+    auto const check = [&](std::string_view const name, Command const command) {
+        return string == name ? command : Command::unknown;
+    };
+
+    switch (hashOscString(string)) {
+    case hashOscString("pol"):
+        return check("pol", Command::polarRadian);
+    case hashOscString("deg"):
+        return check("deg", Command::polarDegree);
+    case hashOscString("car"):
+        return check("car", Command::cartesian);
+    case hashOscString("batch"):
+        return check("batch", Command::batch);
+    case hashOscString("clr"):
+        return check("clr", Command::clear);
+    case hashOscString("alg"):
+        return check("alg", Command::hybridMode);
+    case hashOscString("reset"):
+        return check("reset", Command::legacyReset);
+    case hashOscString("colour"):
+        return check("colour", Command::colour);
+    default:
+        return Command::unknown;
     }
-    return "<INVALID TYPE>";
 }
 
 //==============================================================================
-juce::String messageToString(juce::OSCMessage const & message)
+/** Angles as sent by the controllers : clockwise, starting from the front. */
+Position polarRadianToPosition(float const azimuth, float const zenith, float const radius) noexcept
 {
-    static constexpr auto SEPARATOR{ ", " };
+    auto const correctedAzimuth{ HALF_PI - radians_t{ azimuth } };
+    radians_t const correctedZenith{ zenith };
+    return Position{ PolarVector{ correctedAzimuth.balanced(), correctedZenith.balanced(), radius } };
+}
 
-    auto result{ juce::String{ "[" } + message.getAddressPattern().toString() + "] " };
+//==============================================================================
+Position polarDegreeToPosition(float const azimuth, float const zenith, float const radius) noexcept
+{
+    return polarRadianToPosition(radians_t{ degrees_t{ azimuth } }.get(),
+                                 radians_t{ degrees_t{ zenith } }.get(),
+                                 radius);
+}
 
-    for (auto const & argument : message) {
-        result += SEPARATOR + argumentToString(argument);
+//==============================================================================
+/** The value of an int16 "batch" entry. Angles cover a whole turn, lengths [-4, 4] and spans [0, 1]. */
+float dequantize(std::int16_t const value, std::uint8_t const coordinateType, size_t const valueIndex) noexcept
+{
+    static constexpr auto ONE_HALF_TURN{ 32768.0f };
+    static constexpr auto ONE_LENGTH_UNIT{ 8192.0f };
+    static constexpr auto FULL_SPAN{ 32767.0f };
+
+    auto const isAngle{ valueIndex < 2 && coordinateType != BATCH_CARTESIAN };
+    if (isAngle) {
+        auto const halfTurn{ coordinateType == BATCH_POLAR_DEGREE ? 180.0f : juce::MathConstants<float>::pi };
+        return static_cast<float>(value) * halfTurn / ONE_HALF_TURN;
     }
+    if (valueIndex < 3) {
+        return static_cast<float>(value) / ONE_LENGTH_UNIT;
+    }
+    return static_cast<float>(value) / FULL_SPAN;
+}
 
-    return result;
+//==============================================================================
+juce::String toJuceString(std::string_view const string)
+{
+    return juce::String{ string.data(), string.size() };
 }
 
 } // namespace
 
+//==============================================================================
+OscInput::OscInput(MainContentComponent & parent, LogBuffer & logBuffer)
+    : juce::Thread("SpatGRIS OSC input")
+    , mMainContentComponent(parent)
+    , mLogBuffer(logBuffer)
+{
+}
+
 //==============================================================================
 OscInput::~OscInput()
 {
-    disconnect();
+    closeConnection();
 }
 
 //==============================================================================
 bool OscInput::startConnection(int const port)
 {
-    auto const success = connect(port);
-    addListener(this);
-    return success;
+    closeConnection();
+
+    mSocket = std::make_unique<juce::DatagramSocket>(false);
+    if (!mSocket->bindToPort(port)) {
+        mSocket.reset();
+        return false;
+    }
+
+    startThread();
+    return true;
 }
 
 //==============================================================================
-void OscInput::processSourcePositionMessage(juce::OSCMessage const & message) const noexcept
+bool OscInput::closeConnection()
+{
+    if (mSocket != nullptr) {
+        signalThreadShouldExit();
+        mSocket->shutdown();
+        stopThread(10000);
+        mSocket.reset();
+    }
+    return true;
+}
+
+//==============================================================================
+void OscInput::processSourcePositionMessage(OscMessageView const & message) const noexcept
 {
     auto const sourceIndex{ extractSourceIndex(message[1], SourceIndexBase::fromOne) };
     if (!sourceIndex) {
@@ -92,69 +171,134 @@ void OscInput::processSourcePositionMessage(juce::OSCMessage const & message) co
     auto const azimuthSpan{ message[5].getFloat32() };
     auto const zenithSpan{ message[6].getFloat32() };
 
-    auto const coordinateType{ message[0].getString() };
-    if (coordinateType == "pol") {
+    switch (getCommand(message[0].getString())) {
+    case Command::polarRadian:
         processPolarRadianSourcePositionMessage(message, *sourceIndex, azimuthSpan, zenithSpan);
         return;
-    }
-    if (coordinateType == "deg") {
+    case Command::polarDegree:
         processPolarDegreeSourcePosition(message, *sourceIndex, azimuthSpan, zenithSpan);
         return;
-    }
-    if (coordinateType == "car") {
+    case Command::cartesian:
         processCartesianSourcePositionMessage(message, *sourceIndex, azimuthSpan, zenithSpan);
         return;
+    case Command::unknown:
+    case Command::batch:
+    case Command::clear:
+    case Command::hybridMode:
+    case Command::legacyReset:
+    case Command::colour:
+        break;
     }
     jassertfalse;
 }
 
 //==============================================================================
-void OscInput::processPolarRadianSourcePositionMessage(juce::OSCMessage const & message,
+void OscInput::processPolarRadianSourcePositionMessage(OscMessageView const & message,
                                                        source_index_t const sourceIndex,
                                                        float const azimuthSpan,
                                                        float const zenithSpan) const noexcept
 {
-    auto const azimuth{ HALF_PI - radians_t{ message[2].getFloat32() } };
-    radians_t const zenith{ message[3].getFloat32() };
-    float const radius{ message[4].getFloat32() };
-
-    Position const position{ PolarVector{ azimuth.balanced(), zenith.balanced(), radius } };
-    mMainContentComponent.setSourcePosition(sourceIndex, position, azimuthSpan, zenithSpan);
+    auto const position{ polarRadianToPosition(message[2].getFloat32(),
+                                               message[3].getFloat32(),
+                                               message[4].getFloat32()) };
+    mMainContentComponent.setSourcePosition(sourceIndex, position, azimuthSpan, zenithSpan, mScheduledTimeMs);
 }
 
 //==============================================================================
-void OscInput::processPolarDegreeSourcePosition(juce::OSCMessage const & message,
+void OscInput::processPolarDegreeSourcePosition(OscMessageView const & message,
                                                 source_index_t const sourceIndex,
                                                 float const azimuthSpan,
                                                 float const zenithSpan) const noexcept
 {
-    auto const azimuth{ HALF_PI - radians_t{ degrees_t{ message[2].getFloat32() } } };
-    radians_t const zenith{ degrees_t{ message[3].getFloat32() } };
-    float const radius{ message[4].getFloat32() };
-
-    Position const position{ PolarVector{ azimuth.balanced(), zenith.balanced(), radius } };
-    mMainContentComponent.setSourcePosition(sourceIndex, position, azimuthSpan, zenithSpan);
+    auto const position{ polarDegreeToPosition(message[2].getFloat32(),
+                                               message[3].getFloat32(),
+                                               message[4].getFloat32()) };
+    mMainContentComponent.setSourcePosition(sourceIndex, position, azimuthSpan, zenithSpan, mScheduledTimeMs);
 }
 
 //==============================================================================
-void OscInput::processCartesianSourcePositionMessage(juce::OSCMessage const & message,
+void OscInput::processCartesianSourcePositionMessage(OscMessageView const & message,
                                                      source_index_t const sourceIndex,
                                                      float const horizontalSpan,
                                                      float const verticalSpan) const noexcept
 {
-    auto const x{ message[2].getFloat32() };
-    auto const y{ message[3].getFloat32() };
-    auto const z{ message[4].getFloat32() };
+    Position const position{ CartesianVector{ message[2].getFloat32(),
+                                              message[3].getFloat32(),
+                                              message[4].getFloat32() } };
+    mMainContentComponent.setSourcePosition(sourceIndex, position, horizontalSpan, verticalSpan, mScheduledTimeMs);
+}
+
+//==============================================================================
+void OscInput::processSourcePositionBatchMessage(OscMessageView const & message) const noexcept
+{
+    auto const blob{ message[1].getBlob() };
+    if (static_cast<int>(blob.size()) < BATCH_HEADER_SIZE) {
+        addErrorToBuffer("source position batch is too short.");
+        return;
+    }
+
+    auto const * const bytes{ reinterpret_cast<std::uint8_t const *>(blob.data()) };
+    auto const encoding{ bytes[0] };
+    auto const numEntries{ static_cast<int>(juce::ByteOrder::bigEndianShort(bytes + 2)) };
+    if (encoding != BATCH_FLOAT32_ENCODING && encoding != BATCH_INT16_ENCODING) {
+        addErrorToBuffer("unknown source position batch encoding.");
+        return;
+    }
+    auto const isQuantized{ encoding == BATCH_INT16_ENCODING };
+    auto const valueSize{ isQuantized ? 2 : 4 };
+    auto const entrySize{ BATCH_ENTRY_HEADER_SIZE + BATCH_NUM_VALUES * valueSize };
+    if (static_cast<int>(blob.size()) != BATCH_HEADER_SIZE + numEntries * entrySize) {
+        addErrorToBuffer("source position batch size does not match its number of entries.");
+        return;
+    }
+
+    // Every entry only leaves its position in a mailbox : the whole frame is applied with a single update.
+    for (int entryIndex{}; entryIndex < numEntries; ++entryIndex) {
+        auto const * const entry{ bytes + BATCH_HEADER_SIZE + entryIndex * entrySize };
+        source_index_t const sourceIndex{ static_cast<int>(juce::ByteOrder::bigEndianShort(entry)) };
+        if (!LEGAL_SOURCE_INDEX_RANGE.contains(sourceIndex)) {
+            addErrorToBuffer("source index out of range.");
+            continue;
+        }
+        auto const coordinateType{ entry[2] };
+
+        std::array<float, BATCH_NUM_VALUES> values{};
+        for (size_t i{}; i < values.size(); ++i) {
+            auto const * const value{ entry + BATCH_ENTRY_HEADER_SIZE + static_cast<int>(i) * valueSize };
+            if (isQuantized) {
+                auto const quantized{ static_cast<std::int16_t>(juce::ByteOrder::bigEndianShort(value)) };
+                values[i] = dequantize(quantized, coordinateType, i);
+            } else {
+                auto const bits{ juce::ByteOrder::bigEndianInt(value) };
+                std::memcpy(&values[i], &bits, sizeof(float));
+            }
+        }
 
-    Position const position{ CartesianVector{ x, y, z } };
-    mMainContentComponent.setSourcePosition(sourceIndex, position, horizontalSpan, verticalSpan);
+        Position position{};
+        switch (coordinateType) {
+        case BATCH_POLAR_RADIAN:
+            position = polarRadianToPosition(values[0], values[1], values[2]);
+            break;
+        case BATCH_POLAR_DEGREE:
+            position = polarDegreeToPosition(values[0], values[1], values[2]);
+            break;
+        case BATCH_CARTESIAN:
+            position = Position{ CartesianVector{ values[0], values[1], values[2] } };
+            break;
+        default:
+            addErrorToBuffer("unknown coordinate type in source position batch.");
+            continue;
+        }
+        mMainContentComponent.setSourcePosition(sourceIndex, position, values[3], values[4], mScheduledTimeMs, false);
+    }
+    mMainContentComponent.wakeUpSpatDataUpdater();
 }
 
 //==============================================================================
-void OscInput::processLegacySourcePositionMessage(juce::OSCMessage const & message) const noexcept
+void OscInput::processLegacySourcePositionMessage(OscMessageView const & message) const noexcept
 {
     // int id, float azi [0, 2pi], float ele [0, pi], float azispan [0, 2],
-    // float elespan [0, 0.5], float distance [0, 1], float gain [0, 1].
+    // float elespan [0, 0.5], float distance [0, 1], then a float gain [0, 1] that can be left out and is ignored.
     auto const sourceIndex{ extractSourceIndex(message[0], SourceIndexBase::fromZero) };
     if (!sourceIndex) {
         return;
@@ -168,13 +312,17 @@ void OscInput::processLegacySourcePositionMessage(juce::OSCMessage const & messa
     jassert(zenithSpan >= 0.0f && zenithSpan <= 1.0f);
     auto const length{ message[5].getFloat32() };
 
-    [[maybe_unused]] auto const gain{ message[6].getFloat32() };
-
-    mMainContentComponent.setLegacySourcePosition(*sourceIndex, azimuth, zenith, length, azimuthSpan, zenithSpan);
+    mMainContentComponent.setLegacySourcePosition(*sourceIndex,
+                                                  azimuth,
+                                                  zenith,
+                                                  length,
+                                                  azimuthSpan,
+                                                  zenithSpan,
+                                                  mScheduledTimeMs);
 }
 
 //==============================================================================
-void OscInput::processSourceResetPositionMessage(juce::OSCMessage const & message) const noexcept
+void OscInput::processSourceResetPositionMessage(OscMessageView const & message) const noexcept
 {
     auto const sourceIndex{ extractSourceIndex(message[1], SourceIndexBase::fromOne) };
     if (sourceIndex) {
@@ -183,7 +331,7 @@ void OscInput::processSourceResetPositionMessage(juce::OSCMessage const & messag
 }
 
 //==============================================================================
-void OscInput::processLegacySourceResetPositionMessage(juce::OSCMessage const & message) const noexcept
+void OscInput::processLegacySourceResetPositionMessage(OscMessageView const & message) const noexcept
 {
     // string "reset", int voice_to_reset.
     auto const sourceIndex{ extractSourceIndex(message[0], SourceIndexBase::fromZero) };
@@ -193,7 +341,7 @@ void OscInput::processLegacySourceResetPositionMessage(juce::OSCMessage const &
 }
 
 //==============================================================================
-void OscInput::processSourceHybridModeMessage(juce::OSCMessage const & message) const noexcept
+void OscInput::processSourceHybridModeMessage(OscMessageView const & message) const noexcept
 {
     auto const sourceIndex{ extractSourceIndex(message[1], SourceIndexBase::fromOne) };
 
@@ -214,7 +362,7 @@ void OscInput::processSourceHybridModeMessage(juce::OSCMessage const & message)
         return {};
     };
 
-    auto const spatMode{ stringToSpatMode(message[2].getString()).and_then(filter_spat_mode) };
+    auto const spatMode{ stringToSpatMode(toJuceString(message[2].getString())).and_then(filter_spat_mode) };
 
     if (!spatMode) {
         addErrorToBuffer("unrecognized hybrid spat mode.");
@@ -230,10 +378,10 @@ void OscInput::processSourceHybridModeMessage(juce::OSCMessage const & message)
 }
 
 //==============================================================================
-void OscInput::processSourceColourMessage(juce::OSCMessage const & message) const noexcept
+void OscInput::processSourceColourMessage(OscMessageView const & message) const noexcept
 {
     auto const sourceIndex{ extractSourceIndex(message[1], SourceIndexBase::fromZero) };
-    auto const sourceColour{ juce::Colour(message[2].getColour().toInt32()) };
+    auto const sourceColour{ juce::Colour(message[2].getColour()) };
 
     if (sourceIndex) {
         juce::MessageManager::callAsync([this, sourceIndex = *sourceIndex, sourceColour] {
@@ -242,14 +390,6 @@ void OscInput::processSourceColourMessage(juce::OSCMessage const & message) cons
     }
 }
 
-//==============================================================================
-void OscInput::addToBuffer(juce::String const & string) const
-{
-    if (mLogBuffer.isActive()) {
-        mLogBuffer.add(string);
-    }
-}
-
 //==============================================================================
 void OscInput::addErrorToBuffer(juce::String const & string) const
 {
@@ -260,20 +400,10 @@ void OscInput::addErrorToBuffer(juce::String const & string) const
 }
 
 //==============================================================================
-void OscInput::oscBundleReceived(const juce::OSCBundle & bundle)
-{
-    for (auto const & element : bundle) {
-        if (element.isMessage())
-            oscMessageReceived(element.getMessage());
-        else if (element.isBundle())
-            oscBundleReceived(element.getBundle());
-    }
-}
-
-//==============================================================================
-OscInput::MessageType OscInput::getMessageType(juce::OSCMessage const & message) const noexcept
+OscInput::MessageType OscInput::getMessageType(OscMessageView const & message) const noexcept
 {
-    if (message.getAddressPattern().toString() != SPAT_GRIS_OSC_ADDRESS) {
+    if (message.getAddressHash() != hashOscString(SPAT_GRIS_OSC_ADDRESS)
+        || message.getAddress() != SPAT_GRIS_OSC_ADDRESS) {
         addErrorToBuffer("wrong OSC address.");
         return MessageType::invalid;
     }
@@ -283,7 +413,7 @@ OscInput::MessageType OscInput::getMessageType(juce::OSCMessage const & message)
         return MessageType::invalid;
     }
 
-    if (!IS_STRING(message[0])) {
+    if (!message[0].isString()) {
         if (message.size() < 6) {
             addErrorToBuffer("expected legacy source position message to have at least 6 arguments.");
             return MessageType::invalid;
@@ -296,7 +426,10 @@ OscInput::MessageType OscInput::getMessageType(juce::OSCMessage const & message)
     }
 
     auto const firstArg{ message[0].getString() };
-    if (firstArg == "pol" || firstArg == "deg" || firstArg == "car") {
+    switch (getCommand(firstArg)) {
+    case Command::polarRadian:
+    case Command::polarDegree:
+    case Command::cartesian:
         if (message.size() != 7) {
             addErrorToBuffer("expected source position message to be exactly 7 arguments long.");
             return MessageType::invalid;
@@ -306,57 +439,65 @@ OscInput::MessageType OscInput::getMessageType(juce::OSCMessage const & message)
             return MessageType::invalid;
         }
         return MessageType::sourcePosition;
-    }
-
-    if (firstArg == "clr") {
+    case Command::batch:
+        if (message.size() != 2) {
+            addErrorToBuffer("expected source position batch message to be exactly 2 arguments long.");
+            return MessageType::invalid;
+        }
+        if (!message[1].isBlob()) {
+            addErrorToBuffer("expected the 2nd argument of a source position batch message to be a blob.");
+            return MessageType::invalid;
+        }
+        return MessageType::sourcePositionBatch;
+    case Command::clear:
         if (message.size() != 2) {
             addErrorToBuffer("expected clear message to be exactly 2 arguments long.");
             return MessageType::invalid;
         }
         return MessageType::resetSourcePosition;
-    }
-
-    if (firstArg == "alg") {
+    case Command::hybridMode:
         if (message.size() != 3) {
             addErrorToBuffer("expected source hybrid mode message to be exactly 3 arguments long.");
             return MessageType::invalid;
         }
-        if (!IS_STRING(message[2])) {
+        if (!message[2].isString()) {
             addErrorToBuffer("expected the 3rd argument of a source hybrid mode message to be a string.");
             return MessageType::invalid;
         }
         return MessageType::sourceHybridMode;
-    }
-
-    if (firstArg == "reset") {
+    case Command::legacyReset:
         if (message.size() != 2) {
             addErrorToBuffer("expected a legacy source reset position message to be exactly 2 arguments long.");
             return MessageType::invalid;
         }
         return MessageType::legacyResetSourcePosition;
-    }
-
-    if (firstArg == "colour") {
+    case Command::colour:
         if (message.size() != 3) {
             addErrorToBuffer("expected a source colour message to be exactly 3 arguments long.");
             return MessageType::invalid;
         }
+        if (!message[2].isColour()) {
+            addErrorToBuffer("expected the 3rd argument of a source colour message to be a colour.");
+            return MessageType::invalid;
+        }
         return MessageType::sourceColour;
+    case Command::unknown:
+        break;
     }
 
-    addErrorToBuffer(juce::String{ "unknown command \"" } + firstArg + "\".");
+    addErrorToBuffer(juce::String{ "unknown command \"" } + toJuceString(firstArg) + "\".");
     return MessageType::invalid;
 }
 
 //==============================================================================
-tl::optional<source_index_t> OscInput::extractSourceIndex(juce::OSCArgument const & arg,
+tl::optional<source_index_t> OscInput::extractSourceIndex(OscArgumentView const & arg,
                                                           SourceIndexBase const base) const noexcept
 {
     auto const offset{ base == SourceIndexBase::fromZero ? 1 : 0 };
     source_index_t result;
-    if (IS_INT(arg)) {
+    if (arg.isInt32()) {
         result = source_index_t{ arg.getInt32() + offset };
-    } else if (IS_FLOAT(arg)) {
+    } else if (arg.isFloat32()) {
         result = source_index_t{ narrow<source_index_t::type>(std::round(arg.getFloat32())) + offset };
     } else {
         addErrorToBuffer("source index should be either an int or a float.");
@@ -371,9 +512,61 @@ tl::optional<source_index_t> OscInput::extractSourceIndex(juce::OSCArgument cons
 }
 
 //==============================================================================
-void OscInput::oscMessageReceived(juce::OSCMessage const & message)
+void OscInput::run()
+{
+    while (!threadShouldExit()) {
+        auto const ready{ mSocket->waitUntilReady(true, 100) };
+        if (threadShouldExit()) {
+            return;
+        }
+        if (ready < 0) {
+            addErrorToBuffer("the OSC socket stopped working, no more messages will be received.");
+            DBG("OSC socket error, the OSC input thread stops.");
+            return;
+        }
+        if (ready == 0) {
+            continue;
+        }
+
+        auto const numBytes{ mSocket->read(mPacket.data(), MAX_PACKET_SIZE, false) };
+        if (numBytes >= 4) {
+            processPacket(numBytes);
+        }
+    }
+}
+
+//==============================================================================
+void OscInput::processPacket(int const size)
+{
+    auto const nowMs{ juce::Time::currentTimeMillis() };
+    auto const isValid{ mDecoder.decode(
+        mPacket.data(),
+        size,
+        [this, nowMs](OscMessageView const & message, OscTimeTag const timeTag) {
+            // The positions of a bundle with a time tag in the future are held until then.
+            mScheduledTimeMs = tl::nullopt;
+            if (!timeTag.isImmediate() && timeTag.toMilliseconds() > nowMs) {
+                if (!PositionSchedule::isWithinHorizon(timeTag.toMilliseconds(), nowMs)) {
+                    addErrorToBuffer("time tag more than " + juce::String{ PositionSchedule::MAX_AHEAD_MS / 1000 }
+                                     + " seconds in the future, check that the clocks are synchronized.");
+                    return;
+                }
+                mScheduledTimeMs = timeTag.toMilliseconds();
+            }
+            processMessage(message);
+        }) };
+    if (!isValid) {
+        addErrorToBuffer("malformed OSC packet.");
+    }
+}
+
+//==============================================================================
+void OscInput::processMessage(OscMessageView const & message)
 {
-    addToBuffer(messageToString(message));
+    // Only formatted when someone is looking.
+    if (mLogBuffer.isActive()) {
+        mLogBuffer.add(message.toString());
+    }
 
     switch (getMessageType(message)) {
     case MessageType::legacySourcePosition:
@@ -385,6 +578,9 @@ void OscInput::oscMessageReceived(juce::OSCMessage const & message)
     case MessageType::sourcePosition:
         processSourcePositionMessage(message);
         return;
+    case MessageType::sourcePositionBatch:
+        processSourcePositionBatchMessage(message);
+        return;
     case MessageType::resetSourcePosition:
         processSourceResetPositionMessage(message);
         return;
@@ -21,20 +21,31 @@
 
 #include "Containers/sg_LogBuffer.hpp"
 #include "Data/StrongTypes/sg_SourceIndex.hpp"
+#include "sg_OscPacketDecoder.hpp"
 #include "tl/optional.hpp"
 
+#include <array>
+
 namespace gris
 {
 class MainContentComponent;
 
 //==============================================================================
-class OscInput final
-    : private juce::OSCReceiver
-    , private juce::OSCReceiver::Listener<juce::OSCReceiver::RealtimeCallback>
+/** Receives the OSC messages of the controllers on its own thread.
+ *
+ * The packets are read from the socket into a fixed buffer and decoded in place by an OscPacketDecoder : nothing is
+ * allocated for a position message, and the messages are only formatted as text when the OSC monitor is open.
+ *
+ * The positions of a bundle whose time tag is in the future are scheduled instead of being applied right away. The
+ * other messages of the bundle, "clr" included, are still applied as they arrive. A bundle more than a few seconds
+ * ahead is rejected.
+ */
+class OscInput final : private juce::Thread
 {
     enum class MessageType {
         invalid,
         sourcePosition,
+        sourcePositionBatch,
         resetSourcePosition,
         sourceHybridMode,
         legacySourcePosition,
@@ -42,55 +53,64 @@ class OscInput final
         sourceColour
     };
 
+    /** The largest UDP payload. */
+    static constexpr int MAX_PACKET_SIZE = 65535;
+
     MainContentComponent & mMainContentComponent;
     LogBuffer & mLogBuffer;
+    std::unique_ptr<juce::DatagramSocket> mSocket{};
+    // Receiver thread only.
+    OscPacketDecoder mDecoder{};
+    std::array<char, MAX_PACKET_SIZE> mPacket{};
+    /** When the positions of the message being processed are due, if it came in a bundle meant for later. */
+    tl::optional<juce::int64> mScheduledTimeMs{};
 
 public:
     //==============================================================================
-    OscInput(MainContentComponent & parent, LogBuffer & logBuffer)
-        : mMainContentComponent(parent)
-        , mLogBuffer(logBuffer)
-    {
-    }
+    OscInput(MainContentComponent & parent, LogBuffer & logBuffer);
     OscInput() = delete;
     ~OscInput() override;
     SG_DELETE_COPY_AND_MOVE(OscInput)
     //==============================================================================
     bool startConnection(int port);
-    bool closeConnection() { return this->disconnect(); }
+    bool closeConnection();
+    //==============================================================================
+    /** True when called from the thread that receives and processes the packets. */
+    [[nodiscard]] bool isReceiverThread() const noexcept { return getThreadId() == getCurrentThreadId(); }
 
 private:
     //==============================================================================
-    void processSourcePositionMessage(juce::OSCMessage const & message) const noexcept;
-    void processPolarRadianSourcePositionMessage(juce::OSCMessage const & message,
+    void processSourcePositionMessage(OscMessageView const & message) const noexcept;
+    void processPolarRadianSourcePositionMessage(OscMessageView const & message,
                                                  source_index_t sourceIndex,
                                                  float azimuthSpan,
                                                  float zenithSpan) const noexcept;
-    void processPolarDegreeSourcePosition(juce::OSCMessage const & message,
+    void processPolarDegreeSourcePosition(OscMessageView const & message,
                                           source_index_t sourceIndex,
                                           float azimuthSpan,
                                           float zenithSpan) const noexcept;
-    void processCartesianSourcePositionMessage(juce::OSCMessage const & message,
+    void processCartesianSourcePositionMessage(OscMessageView const & message,
                                                source_index_t sourceIndex,
                                                float horizontalSpan,
                                                float verticalSpan) const noexcept;
-    void processLegacySourcePositionMessage(juce::OSCMessage const & message) const noexcept;
-    void processSourceResetPositionMessage(juce::OSCMessage const & message) const noexcept;
-    void processLegacySourceResetPositionMessage(juce::OSCMessage const & message) const noexcept;
-    void processSourceHybridModeMessage(juce::OSCMessage const & message) const noexcept;
-    void processSourceColourMessage(juce::OSCMessage const & message) const noexcept;
-    MessageType getMessageType(juce::OSCMessage const & message) const noexcept;
+    void processSourcePositionBatchMessage(OscMessageView const & message) const noexcept;
+    void processLegacySourcePositionMessage(OscMessageView const & message) const noexcept;
+    void processSourceResetPositionMessage(OscMessageView const & message) const noexcept;
+    void processLegacySourceResetPositionMessage(OscMessageView const & message) const noexcept;
+    void processSourceHybridModeMessage(OscMessageView const & message) const noexcept;
+    void processSourceColourMessage(OscMessageView const & message) const noexcept;
+    MessageType getMessageType(OscMessageView const & message) const noexcept;
 
     enum class SourceIndexBase { fromZero, fromOne };
 
-    tl::optional<source_index_t> extractSourceIndex(juce::OSCArgument const & arg,
+    tl::optional<source_index_t> extractSourceIndex(OscArgumentView const & arg,
                                                     SourceIndexBase const base) const noexcept;
     //==============================================================================
-    void addToBuffer(juce::String const & string) const;
     void addErrorToBuffer(juce::String const & string) const;
     //==============================================================================
-    void oscMessageReceived(juce::OSCMessage const & message) override;
-    void oscBundleReceived(juce::OSCBundle const & bundle) override;
+    void run() override;
+    void processPacket(int size);
+    void processMessage(OscMessageView const & message);
     //==============================================================================
     JUCE_LEAK_DETECTOR(OscInput)
 };
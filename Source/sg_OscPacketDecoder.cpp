@@ -0,0 +1,270 @@
+/*
+ This file is part of SpatGRIS.
+
+ Developers: Gaël Lane Lépine, Samuel Béland, Olivier Bélanger, Nicolas Masson
+
+ SpatGRIS is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ SpatGRIS is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with SpatGRIS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sg_OscPacketDecoder.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace gris
+{
+namespace
+{
+/** From 1900, where NTP starts, to 1970. */
+constexpr juce::int64 NTP_TO_UNIX_EPOCH_SECONDS = 2208988800;
+
+//==============================================================================
+std::uint32_t readBigEndianUInt32(char const * data) noexcept
+{
+    return juce::ByteOrder::bigEndianInt(data);
+}
+
+//==============================================================================
+/** Everything in an OSC packet is aligned on 4 bytes. */
+constexpr int padToFourBytes(int const size) noexcept
+{
+    return (size + 3) & ~3;
+}
+
+//==============================================================================
+/** The size of a padded OSC string, including its null terminator and padding, or -1 if it is not terminated. */
+int getPaddedStringSize(char const * data, int const remainingSize) noexcept
+{
+    auto const * const terminator{ static_cast<char const *>(
+        std::memchr(data, '\0', static_cast<size_t>(std::max(remainingSize, 0)))) };
+    if (terminator == nullptr) {
+        return -1;
+    }
+    auto const paddedSize{ padToFourBytes(static_cast<int>(terminator - data) + 1) };
+    return paddedSize <= remainingSize ? paddedSize : -1;
+}
+
+//==============================================================================
+/** The number of bytes taken by an argument of this type, or -1 if the type is not supported. */
+int getArgumentSize(char const type, char const * data, int const remainingSize) noexcept
+{
+    switch (type) {
+    case 'i':
+    case 'f':
+    case 'r':
+    case 'c':
+    case 'm':
+        return 4;
+    case 'h':
+    case 'd':
+    case 't':
+        return 8;
+    case 's':
+    case 'S':
+        return getPaddedStringSize(data, remainingSize);
+    case 'b': {
+        if (remainingSize < 4) {
+            return -1;
+        }
+        auto const blobSize{ static_cast<std::int32_t>(readBigEndianUInt32(data)) };
+        // Checked before padding it : a size close to INT32_MAX would overflow.
+        if (blobSize < 0 || blobSize > remainingSize - 4) {
+            return -1;
+        }
+        return 4 + padToFourBytes(blobSize);
+    }
+    case 'T':
+    case 'F':
+    case 'N':
+    case 'I':
+        return 0;
+    default:
+        return -1;
+    }
+}
+
+} // namespace
+
+//==============================================================================
+OscArgumentView::OscArgumentView(char const type, char const * data, int const size) noexcept
+    : mType(type)
+    , mData(data)
+    , mSize(size)
+{
+}
+
+//==============================================================================
+std::int32_t OscArgumentView::getInt32() const noexcept
+{
+    jassert(isInt32());
+    return static_cast<std::int32_t>(readBigEndianUInt32(mData));
+}
+
+//==============================================================================
+float OscArgumentView::getFloat32() const noexcept
+{
+    jassert(isFloat32());
+    auto const bits{ readBigEndianUInt32(mData) };
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+//==============================================================================
+std::string_view OscArgumentView::getString() const noexcept
+{
+    jassert(isString());
+    // The size includes the padding : the string stops at the first null character.
+    return std::string_view{ mData, std::strlen(mData) };
+}
+
+//==============================================================================
+std::uint32_t OscArgumentView::getColour() const noexcept
+{
+    jassert(isColour());
+    return readBigEndianUInt32(mData);
+}
+
+//==============================================================================
+std::string_view OscArgumentView::getBlob() const noexcept
+{
+    jassert(isBlob());
+    auto const size{ readBigEndianUInt32(mData) };
+    return std::string_view{ mData + 4, size };
+}
+
+//==============================================================================
+juce::String OscArgumentView::toString() const
+{
+    if (isFloat32()) {
+        return juce::String{ getFloat32() };
+    }
+    if (isInt32()) {
+        return juce::String{ getInt32() };
+    }
+    if (isString()) {
+        auto const string{ getString() };
+        return juce::String{ string.data(), string.size() };
+    }
+    if (isBlob()) {
+        return juce::String{ "<" } + juce::String{ static_cast<int>(getBlob().size()) } + " BYTES BLOB>";
+    }
+    return "<INVALID TYPE>";
+}
+
+//==============================================================================
+juce::int64 OscTimeTag::toMilliseconds() const noexcept
+{
+    auto const seconds{ static_cast<juce::int64>(mRaw >> 32) - NTP_TO_UNIX_EPOCH_SECONDS };
+    auto const fraction{ static_cast<juce::int64>(mRaw & 0xFFFFFFFFu) };
+    return seconds * 1000 + ((fraction * 1000) >> 32);
+}
+
+//==============================================================================
+bool OscMessageView::parse(char const * data, int const size) noexcept
+{
+    mNumArguments = 0;
+
+    if (size <= 0 || size % 4 != 0 || data[0] != '/') {
+        return false;
+    }
+
+    auto const addressSize{ getPaddedStringSize(data, size) };
+    if (addressSize < 0) {
+        return false;
+    }
+    mAddress = std::string_view{ data, std::strlen(data) };
+    mAddressHash = hashOscString(mAddress);
+
+    auto offset{ addressSize };
+    if (offset == size) {
+        // Some old implementations leave out the type tags of messages without arguments.
+        return true;
+    }
+    if (data[offset] != ',') {
+        return false;
+    }
+    auto const typeTagsSize{ getPaddedStringSize(data + offset, size - offset) };
+    if (typeTagsSize < 0) {
+        return false;
+    }
+    std::string_view const typeTags{ data + offset + 1, std::strlen(data + offset + 1) };
+    if (typeTags.size() > MAX_NUM_ARGUMENTS) {
+        return false;
+    }
+    offset += typeTagsSize;
+
+    for (auto const type : typeTags) {
+        auto const argumentSize{ getArgumentSize(type, data + offset, size - offset) };
+        if (argumentSize < 0 || argumentSize > size - offset) {
+            mNumArguments = 0;
+            return false;
+        }
+        mArguments[static_cast<size_t>(mNumArguments++)] = OscArgumentView{ type, data + offset, argumentSize };
+        offset += argumentSize;
+    }
+
+    return true;
+}
+
+//==============================================================================
+OscArgumentView const & OscMessageView::operator[](int const index) const noexcept
+{
+    jassert(index >= 0 && index < mNumArguments);
+    return mArguments[static_cast<size_t>(index)];
+}
+
+//==============================================================================
+juce::String OscMessageView::toString() const
+{
+    static constexpr auto SEPARATOR{ ", " };
+
+    auto result{ juce::String{ "[" } + juce::String{ mAddress.data(), mAddress.size() } + "] " };
+
+    for (auto const & argument : *this) {
+        result += SEPARATOR + argument.toString();
+    }
+
+    return result;
+}
+
+//==============================================================================
+bool OscPacketDecoder::isBundle(char const * data, int const size) noexcept
+{
+    static constexpr char BUNDLE_TAG[8]{ '#', 'b', 'u', 'n', 'd', 'l', 'e', '\0' };
+    return size >= 16 && std::memcmp(data, BUNDLE_TAG, sizeof(BUNDLE_TAG)) == 0;
+}
+
+//==============================================================================
+OscTimeTag OscPacketDecoder::getBundleTimeTag(char const * data) noexcept
+{
+    auto const upper{ static_cast<std::uint64_t>(readBigEndianUInt32(data + 8)) };
+    auto const lower{ static_cast<std::uint64_t>(readBigEndianUInt32(data + 12)) };
+    return OscTimeTag{ (upper << 32) | lower };
+}
+
+//==============================================================================
+int OscPacketDecoder::getElementSize(char const * data, int const remainingSize) noexcept
+{
+    if (remainingSize < 4) {
+        return -1;
+    }
+    auto const elementSize{ static_cast<std::int32_t>(readBigEndianUInt32(data)) };
+    if (elementSize <= 0 || elementSize % 4 != 0 || elementSize > remainingSize - 4) {
+        return -1;
+    }
+    return elementSize;
+}
+
+} // namespace gris
@@ -0,0 +1,219 @@
+/*
+ This file is part of SpatGRIS.
+
+ Developers: Gaël Lane Lépine, Samuel Béland, Olivier Bélanger, Nicolas Masson
+
+ SpatGRIS is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ SpatGRIS is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with SpatGRIS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Data/sg_Macros.hpp"
+
+#include <JuceHeader.h>
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace gris
+{
+//==============================================================================
+/** FNV-1a hash of an OSC address or command, so that they can be dispatched with a switch. */
+constexpr std::uint32_t hashOscString(std::string_view const string) noexcept
+{
+    std::uint32_t hash{ 2166136261u };
+    for (auto const c : string) {
+        hash = (hash ^ static_cast<std::uint8_t>(c)) * 16777619u;
+    }
+    return hash;
+}
+
+//==============================================================================
+/** An argument of an OscMessageView. Points into the packet it was read from. */
+class OscArgumentView
+{
+    char mType{};
+    char const * mData{};
+    int mSize{};
+
+public:
+    //==============================================================================
+    OscArgumentView() = default;
+    OscArgumentView(char type, char const * data, int size) noexcept;
+    ~OscArgumentView() = default;
+    SG_DEFAULT_COPY_AND_MOVE(OscArgumentView)
+    //==============================================================================
+    [[nodiscard]] char getType() const noexcept { return mType; }
+    [[nodiscard]] bool isInt32() const noexcept { return mType == 'i'; }
+    [[nodiscard]] bool isFloat32() const noexcept { return mType == 'f'; }
+    [[nodiscard]] bool isString() const noexcept { return mType == 's' || mType == 'S'; }
+    [[nodiscard]] bool isColour() const noexcept { return mType == 'r'; }
+    [[nodiscard]] bool isBlob() const noexcept { return mType == 'b'; }
+    //==============================================================================
+    [[nodiscard]] std::int32_t getInt32() const noexcept;
+    [[nodiscard]] float getFloat32() const noexcept;
+    [[nodiscard]] std::string_view getString() const noexcept;
+    /** RGBA, the same as juce::OSCColour::toInt32(). */
+    [[nodiscard]] std::uint32_t getColour() const noexcept;
+    /** The bytes of the blob, without its size nor its padding. */
+    [[nodiscard]] std::string_view getBlob() const noexcept;
+    /** Allocates : only meant for the OSC monitor. */
+    [[nodiscard]] juce::String toString() const;
+};
+
+//==============================================================================
+/** An OSC message, read in place from a received packet.
+ *
+ * juce::OSCReceiver builds a juce::OSCMessage, with its juce::Strings and its array of arguments, for every message
+ * it receives. This is a lot of allocations for the hundreds of positions per second that a controller sends. Parsing
+ * an OscMessageView never allocates nor copies anything : the address and the arguments all point into the packet,
+ * which has to outlive the view.
+ */
+class OscMessageView
+{
+public:
+    static constexpr int MAX_NUM_ARGUMENTS = 16;
+
+private:
+    std::string_view mAddress{};
+    std::uint32_t mAddressHash{};
+    std::array<OscArgumentView, MAX_NUM_ARGUMENTS> mArguments{};
+    int mNumArguments{};
+
+public:
+    //==============================================================================
+    OscMessageView() = default;
+    ~OscMessageView() = default;
+    SG_DEFAULT_COPY_AND_MOVE(OscMessageView)
+    //==============================================================================
+    /** Returns false if the data is not a valid OSC message, or if it has more than MAX_NUM_ARGUMENTS arguments. */
+    [[nodiscard]] bool parse(char const * data, int size) noexcept;
+    //==============================================================================
+    [[nodiscard]] std::string_view getAddress() const noexcept { return mAddress; }
+    [[nodiscard]] std::uint32_t getAddressHash() const noexcept { return mAddressHash; }
+    [[nodiscard]] int size() const noexcept { return mNumArguments; }
+    [[nodiscard]] OscArgumentView const & operator[](int index) const noexcept;
+    [[nodiscard]] OscArgumentView const * begin() const noexcept { return mArguments.data(); }
+    [[nodiscard]] OscArgumentView const * end() const noexcept { return mArguments.data() + mNumArguments; }
+    //==============================================================================
+    /** Allocates : only meant for the OSC monitor. */
+    [[nodiscard]] juce::String toString() const;
+};
+
+//==============================================================================
+/** The time tag of an OSC bundle : an NTP time, seconds since 1900 in the upper 32 bits and their fraction in the lower
+ * 32 bits. A message that is not in a bundle is to be processed immediately.
+ */
+class OscTimeTag
+{
+    std::uint64_t mRaw{ IMMEDIATELY };
+
+public:
+    static constexpr std::uint64_t IMMEDIATELY = 1;
+    //==============================================================================
+    OscTimeTag() = default;
+    explicit OscTimeTag(std::uint64_t const raw) noexcept : mRaw(raw) {}
+    ~OscTimeTag() = default;
+    SG_DEFAULT_COPY_AND_MOVE(OscTimeTag)
+    //==============================================================================
+    [[nodiscard]] bool isImmediate() const noexcept { return mRaw == IMMEDIATELY; }
+    /** Milliseconds since 1970, like juce::Time::currentTimeMillis(). */
+    [[nodiscard]] juce::int64 toMilliseconds() const noexcept;
+};
+
+//==============================================================================
+/** Reads the OSC packets received by a socket, without allocating.
+ *
+ * A packet is either a single message or a bundle of messages and other bundles.
+ */
+class OscPacketDecoder
+{
+    /** How deep the bundles can be nested. A packet that goes deeper is malformed. */
+    static constexpr int MAX_BUNDLE_DEPTH = 8;
+
+    OscMessageView mMessage{};
+
+public:
+    //==============================================================================
+    OscPacketDecoder() = default;
+    ~OscPacketDecoder() = default;
+    SG_DELETE_COPY_AND_MOVE(OscPacketDecoder)
+    //==============================================================================
+    /** Calls visitor(OscMessageView const &, OscTimeTag) with every message of a packet, in order, along with the time
+     * tag of the bundle that contains it.
+     *
+     * Returns false if the packet is malformed. The messages that came before the error were still visited. The views
+     * are only valid during the call to the visitor.
+     */
+    template<typename Visitor>
+    bool decode(char const * data, int size, Visitor && visitor) noexcept;
+
+private:
+    //==============================================================================
+    template<typename Visitor>
+    bool decodeElement(char const * data, int size, OscTimeTag timeTag, int depth, Visitor && visitor) noexcept;
+    //==============================================================================
+    [[nodiscard]] static bool isBundle(char const * data, int size) noexcept;
+    [[nodiscard]] static OscTimeTag getBundleTimeTag(char const * data) noexcept;
+    /** The size of the bundle element that starts at data, or -1 if it does not fit. */
+    [[nodiscard]] static int getElementSize(char const * data, int remainingSize) noexcept;
+    //==============================================================================
+    JUCE_LEAK_DETECTOR(OscPacketDecoder)
+};
+
+//==============================================================================
+template<typename Visitor>
+bool OscPacketDecoder::decode(char const * data, int const size, Visitor && visitor) noexcept
+{
+    return decodeElement(data, size, OscTimeTag{}, 0, visitor);
+}
+
+//==============================================================================
+template<typename Visitor>
+bool OscPacketDecoder::decodeElement(char const * data,
+                                     int const size,
+                                     OscTimeTag const timeTag,
+                                     int const depth,
+                                     Visitor && visitor) noexcept
+{
+    if (!isBundle(data, size)) {
+        if (!mMessage.parse(data, size)) {
+            return false;
+        }
+        visitor(static_cast<OscMessageView const &>(mMessage), timeTag);
+        return true;
+    }
+
+    if (depth >= MAX_BUNDLE_DEPTH) {
+        return false;
+    }
+
+    // "#bundle", then the time tag. The time tag of a nested bundle replaces the one of its parent.
+    static constexpr int BUNDLE_HEADER_SIZE = 16;
+    auto const bundleTimeTag{ getBundleTimeTag(data) };
+    for (auto offset{ BUNDLE_HEADER_SIZE }; offset < size;) {
+        auto const elementSize{ getElementSize(data + offset, size - offset) };
+        if (elementSize < 0) {
+            return false;
+        }
+        offset += 4;
+        if (!decodeElement(data + offset, elementSize, bundleTimeTag, depth + 1, visitor)) {
+            return false;
+        }
+        offset += elementSize;
+    }
+    return true;
+}
+
+} // namespace gris
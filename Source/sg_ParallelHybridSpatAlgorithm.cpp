@@ -0,0 +1,220 @@
+/*
+ This file is part of SpatGRIS.
+
+ Developers: Gaël Lane Lépine, Samuel Béland, Olivier Bélanger, Nicolas Masson
+
+ SpatGRIS is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ SpatGRIS is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with SpatGRIS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sg_ParallelHybridSpatAlgorithm.hpp"
+
+namespace gris
+{
+namespace
+{
+// Some tens of microseconds : long enough to catch the next block of a busy callback without sleeping.
+constexpr auto NUM_SPINS_BEFORE_SLEEPING = 20000;
+constexpr auto WORKER_PRIORITY = 9;
+
+} // namespace
+
+//==============================================================================
+ParallelHybridSpatAlgorithm::ParallelHybridSpatAlgorithm(std::unique_ptr<AbstractSpatAlgorithm> vbap,
+                                                         std::unique_ptr<AbstractSpatAlgorithm> mbap,
+                                                         SpeakersData const & speakers,
+                                                         int const bufferSize)
+    : juce::Thread("SpatGRIS hybrid MBAP worker")
+    , mVbap(std::move(vbap))
+    , mMbap(std::move(mbap))
+{
+    jassert(mVbap && mMbap);
+
+    juce::Array<output_patch_t> outputPatches{};
+    for (auto const speaker : speakers) {
+        outputPatches.add(speaker.key);
+    }
+    mMbapBuffer.init(outputPatches);
+    mMbapBuffer.setNumSamples(bufferSize);
+    // Never used since there is no stereo reduction, but process() still wants one.
+    mMbapStereoBuffer.setSize(2, bufferSize);
+    mMbapStereoBuffer.clear();
+
+    // A worker that shares the only core with the audio thread could only slow it down.
+    if (juce::SystemStats::getNumCpus() > 1) {
+        mIsWorkerRunning = startRealtimeThread(juce::Thread::RealtimeOptions{}.withPriority(WORKER_PRIORITY));
+    }
+}
+
+//==============================================================================
+ParallelHybridSpatAlgorithm::~ParallelHybridSpatAlgorithm()
+{
+    signalThreadShouldExit();
+    notify();
+    stopThread(-1);
+}
+
+//==============================================================================
+void ParallelHybridSpatAlgorithm::updateSpatData(source_index_t const sourceIndex,
+                                                 SourceData const & sourceData) noexcept
+{
+    // The half that does not handle the source sees it without a position, which silences it there.
+    auto withoutPosition{ sourceData };
+    withoutPosition.position = tl::nullopt;
+
+    auto const isVbap{ sourceData.hybridSpatMode == SpatMode::vbap };
+    mVbap->updateSpatData(sourceIndex, isVbap ? sourceData : withoutPosition);
+    mMbap->updateSpatData(sourceIndex, isVbap ? withoutPosition : sourceData);
+}
+
+//==============================================================================
+void ParallelHybridSpatAlgorithm::process(AudioConfig const & config,
+                                          SourceAudioBuffer & sourcesBuffer,
+                                          SpeakerAudioBuffer & speakersBuffer,
+                                          juce::AudioBuffer<float> & stereoBuffer,
+                                          SourcePeaks const & sourcePeaks,
+                                          SpeakersAudioConfig const * altSpeakerConfig)
+{
+    auto const numSamples{ speakersBuffer.getNumSamples() };
+    mMbapBuffer.setNumSamples(numSamples);
+    mMbapBuffer.silence();
+
+    mJobConfig = &config;
+    mJobSources = &sourcesBuffer;
+    mJobPeaks = &sourcePeaks;
+
+    if (mIsWorkerRunning) {
+        mIsJobDone.store(false);
+        mHasJob.store(true);
+        if (mIsWorkerSleeping.load()) {
+            notify();
+        }
+    }
+
+    mVbap->process(config, sourcesBuffer, speakersBuffer, stereoBuffer, sourcePeaks, altSpeakerConfig);
+
+    if (!mIsWorkerRunning || claimJob()) {
+        processMbap();
+    } else {
+        // The worker is rendering it right now : this is bounded by one MBAP render, as long as rendering it here.
+        while (!mIsJobDone.load()) {
+        }
+    }
+
+    jassert(mMbapBuffer.size() == speakersBuffer.size());
+    for (auto const channel : speakersBuffer) {
+        channel.value->addFrom(0, 0, mMbapBuffer[channel.key], 0, 0, numSamples);
+    }
+}
+
+//==============================================================================
+juce::Array<Triplet> ParallelHybridSpatAlgorithm::getTriplets() const noexcept
+{
+    return mVbap->getTriplets();
+}
+
+//==============================================================================
+bool ParallelHybridSpatAlgorithm::hasTriplets() const noexcept
+{
+    return mVbap->hasTriplets();
+}
+
+//==============================================================================
+tl::optional<AbstractSpatAlgorithm::Error> ParallelHybridSpatAlgorithm::getError() const noexcept
+{
+    if (auto const error{ mVbap->getError() }) {
+        return error;
+    }
+    return mMbap->getError();
+}
+
+//==============================================================================
+std::unique_ptr<AbstractSpatAlgorithm> ParallelHybridSpatAlgorithm::make(SpeakerSetup const & speakerSetup,
+                                                                         SourcesData const & sources,
+                                                                         double const sampleRate,
+                                                                         int const bufferSize)
+{
+    auto vbap{ AbstractSpatAlgorithm::make(speakerSetup,
+                                           SpatMode::vbap,
+                                           tl::nullopt,
+                                           sources,
+                                           sampleRate,
+                                           bufferSize,
+                                           false) };
+    auto mbap{ AbstractSpatAlgorithm::make(speakerSetup,
+                                           SpatMode::mbap,
+                                           tl::nullopt,
+                                           sources,
+                                           sampleRate,
+                                           bufferSize,
+                                           false) };
+    if (vbap->getError() || mbap->getError()) {
+        // Let the regular algorithm report the error like it always did.
+        return AbstractSpatAlgorithm::make(speakerSetup,
+                                           SpatMode::hybrid,
+                                           tl::nullopt,
+                                           sources,
+                                           sampleRate,
+                                           bufferSize,
+                                           false);
+    }
+
+    auto result{ std::make_unique<ParallelHybridSpatAlgorithm>(std::move(vbap),
+                                                                std::move(mbap),
+                                                                speakerSetup.speakers,
+                                                                bufferSize) };
+    for (auto const source : sources) {
+        result->updateSpatData(source.key, *source.value);
+    }
+    return result;
+}
+
+//==============================================================================
+void ParallelHybridSpatAlgorithm::run()
+{
+    int numSpins{};
+    while (!threadShouldExit()) {
+        if (claimJob()) {
+            processMbap();
+            mIsJobDone.store(true);
+            numSpins = 0;
+            continue;
+        }
+        if (++numSpins < NUM_SPINS_BEFORE_SLEEPING) {
+            continue;
+        }
+        // Checked again once the flag is up : a job posted since then comes with a notify(), which leaves the event
+        // signaled if it happens before the wait. The destructor notifies too.
+        mIsWorkerSleeping.store(true);
+        if (!mHasJob.load()) {
+            wait(-1);
+        }
+        mIsWorkerSleeping.store(false);
+        numSpins = 0;
+    }
+}
+
+//==============================================================================
+bool ParallelHybridSpatAlgorithm::claimJob() noexcept
+{
+    auto hasJob{ true };
+    return mHasJob.compare_exchange_strong(hasJob, false);
+}
+
+//==============================================================================
+void ParallelHybridSpatAlgorithm::processMbap() noexcept
+{
+    mMbap->process(*mJobConfig, *mJobSources, mMbapBuffer, mMbapStereoBuffer, *mJobPeaks, nullptr);
+}
+
+} // namespace gris
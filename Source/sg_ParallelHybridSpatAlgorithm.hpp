@@ -0,0 +1,102 @@
+/*
+ This file is part of SpatGRIS.
+
+ Developers: Gaël Lane Lépine, Samuel Béland, Olivier Bélanger, Nicolas Masson
+
+ SpatGRIS is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ SpatGRIS is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with SpatGRIS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Data/sg_LogicStrucs.hpp"
+#include "Data/sg_Macros.hpp"
+#include "sg_AbstractSpatAlgorithm.hpp"
+
+#include <JuceHeader.h>
+#include <atomic>
+
+namespace gris
+{
+//==============================================================================
+/** Hybrid mode spread over two cores : the VBAP sources on the audio thread and the MBAP sources on a worker.
+ *
+ * Every source only belongs to one of the two algorithms : the other one sees it without a position, which makes it
+ * silent there. Both halves render at the same time, the MBAP one into a buffer of its own, which is then added to the
+ * speakers once. The stereo reductions are not supported.
+ *
+ * This is two threads at most : each half is a single core algorithm. Splitting them further would have three pools
+ * of workers compete for the same cores, which the multicore hybrid of AbstractSpatAlgorithm::make() showed to be
+ * slower.
+ *
+ * The audio thread posts the MBAP half, wakes the worker up if it went to sleep, renders the VBAP half and then takes
+ * the MBAP half back if the worker did not claim it yet. It never waits for the worker to wake up, only for a half that
+ * the worker is already rendering, which takes no longer than rendering it on the audio thread. The worker spins for a
+ * little while after each block, since the next one is never far away, and then sleeps until it gets woken up. On a
+ * single core, there is no worker and the audio thread renders both halves.
+ */
+class ParallelHybridSpatAlgorithm final
+    : public AbstractSpatAlgorithm
+    , private juce::Thread
+{
+    std::unique_ptr<AbstractSpatAlgorithm> mVbap;
+    std::unique_ptr<AbstractSpatAlgorithm> mMbap;
+    SpeakerAudioBuffer mMbapBuffer{};
+    juce::AudioBuffer<float> mMbapStereoBuffer{};
+    bool mIsWorkerRunning{};
+    // Handed over to the worker for the duration of a block.
+    AudioConfig const * mJobConfig{};
+    SourceAudioBuffer * mJobSources{};
+    SourcePeaks const * mJobPeaks{};
+    // Set by the audio thread, cleared by whichever thread claims the job.
+    std::atomic<bool> mHasJob{};
+    std::atomic<bool> mIsJobDone{ true };
+    // Set by the worker right before it sleeps, so that the audio thread only wakes it up when it has to.
+    std::atomic<bool> mIsWorkerSleeping{};
+
+public:
+    //==============================================================================
+    ParallelHybridSpatAlgorithm(std::unique_ptr<AbstractSpatAlgorithm> vbap,
+                                std::unique_ptr<AbstractSpatAlgorithm> mbap,
+                                SpeakersData const & speakers,
+                                int bufferSize);
+    ParallelHybridSpatAlgorithm() = delete;
+    ~ParallelHybridSpatAlgorithm() override;
+    SG_DELETE_COPY_AND_MOVE(ParallelHybridSpatAlgorithm)
+    //==============================================================================
+    void updateSpatData(source_index_t sourceIndex, SourceData const & sourceData) noexcept override;
+    void process(AudioConfig const & config,
+                 SourceAudioBuffer & sourcesBuffer,
+                 SpeakerAudioBuffer & speakersBuffer,
+                 juce::AudioBuffer<float> & stereoBuffer,
+                 SourcePeaks const & sourcePeaks,
+                 SpeakersAudioConfig const * altSpeakerConfig) override;
+    [[nodiscard]] juce::Array<Triplet> getTriplets() const noexcept override;
+    [[nodiscard]] bool hasTriplets() const noexcept override;
+    [[nodiscard]] tl::optional<Error> getError() const noexcept override;
+    //==============================================================================
+    /** Falls back to the regular hybrid algorithm if either half can not be built for this speaker setup. */
+    [[nodiscard]] static std::unique_ptr<AbstractSpatAlgorithm>
+        make(SpeakerSetup const & speakerSetup, SourcesData const & sources, double sampleRate, int bufferSize);
+
+private:
+    //==============================================================================
+    void run() override;
+    /** Returns false if the other thread already claimed the job. */
+    [[nodiscard]] bool claimJob() noexcept;
+    void processMbap() noexcept;
+    //==============================================================================
+    JUCE_LEAK_DETECTOR(ParallelHybridSpatAlgorithm)
+};
+
+} // namespace gris
@@ -0,0 +1,91 @@
+/*
+ This file is part of SpatGRIS.
+
+ Developers: Gaël Lane Lépine, Samuel Béland, Olivier Bélanger, Nicolas Masson
+
+ SpatGRIS is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ SpatGRIS is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with SpatGRIS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sg_PositionSchedule.hpp"
+
+namespace gris
+{
+//==============================================================================
+PositionSchedule::PositionSchedule()
+{
+    // The heap never grows past this : collectScheduled() leaves the rest in the FIFO.
+    mPendingEvents.reserve(CAPACITY);
+}
+
+//==============================================================================
+bool PositionSchedule::schedule(Event const & event) noexcept
+{
+    auto const scope{ mFifo.write(1) };
+    if (scope.blockSize1 == 0) {
+        return false;
+    }
+    auto const generation{ mGenerations[toIndex(event.sourceIndex)].load() };
+    mFifoEvents[static_cast<size_t>(scope.startIndex1)] = PendingEvent{ event, generation, 0 };
+    return true;
+}
+
+//==============================================================================
+void PositionSchedule::discard(source_index_t const sourceIndex) noexcept
+{
+    mGenerations[toIndex(sourceIndex)].fetch_add(1);
+}
+
+//==============================================================================
+void PositionSchedule::collectScheduled() noexcept
+{
+    auto const room{ static_cast<int>(mPendingEvents.capacity() - mPendingEvents.size()) };
+    auto const numReady{ std::min(mFifo.getNumReady(), room) };
+    if (numReady == 0) {
+        return;
+    }
+
+    auto const scope{ mFifo.read(numReady) };
+    scope.forEach([this](int const index) {
+        auto pendingEvent{ mFifoEvents[static_cast<size_t>(index)] };
+        pendingEvent.order = mNextOrder++;
+        mPendingEvents.push_back(pendingEvent);
+        std::push_heap(mPendingEvents.begin(), mPendingEvents.end(), comesAfter);
+    });
+}
+
+//==============================================================================
+bool PositionSchedule::isDiscarded(PendingEvent const & pendingEvent) const noexcept
+{
+    return pendingEvent.generation != mGenerations[toIndex(pendingEvent.event.sourceIndex)].load();
+}
+
+//==============================================================================
+bool PositionSchedule::comesAfter(PendingEvent const & a, PendingEvent const & b) noexcept
+{
+    // std::push_heap() keeps the greatest element first : the earliest one has to compare as the greatest.
+    if (a.event.timeMs != b.event.timeMs) {
+        return a.event.timeMs > b.event.timeMs;
+    }
+    return a.order > b.order;
+}
+
+//==============================================================================
+size_t PositionSchedule::toIndex(source_index_t const sourceIndex) noexcept
+{
+    auto const index{ static_cast<size_t>(sourceIndex.get() - source_index_t::OFFSET) };
+    jassert(index < MAX_NUM_SOURCES);
+    return index;
+}
+
+} // namespace gris
@@ -0,0 +1,132 @@
+/*
+ This file is part of SpatGRIS.
+
+ Developers: Gaël Lane Lépine, Samuel Béland, Olivier Bélanger, Nicolas Masson
+
+ SpatGRIS is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ SpatGRIS is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with SpatGRIS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Data/StrongTypes/sg_SourceIndex.hpp"
+#include "Data/sg_Macros.hpp"
+#include "Data/sg_constants.hpp"
+#include "sg_SourcePositionMailboxes.hpp"
+#include "tl/optional.hpp"
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace gris
+{
+//==============================================================================
+/** Source positions that have to be applied at a given time, as sent in OSC bundles with a time tag in the future.
+ *
+ * The OSC thread adds events through a lock-free FIFO and never waits. The consumer moves them to a heap ordered by
+ * time and takes them back out once they are due. Events that share the same time come out in the order they were
+ * scheduled.
+ *
+ * Discarding the events of a source does not touch the FIFO nor the heap : every event is stamped with the generation
+ * of its source when it is scheduled, and the events of an older generation are dropped once they are due.
+ */
+class PositionSchedule
+{
+public:
+    static constexpr auto CAPACITY = 4096;
+    /** An event further ahead than this is most likely from a clock that is off, not from a trajectory planned in
+     * advance. */
+    static constexpr juce::int64 MAX_AHEAD_MS = 5000;
+
+    struct Event {
+        /** Milliseconds since 1970, like juce::Time::currentTimeMillis(). */
+        juce::int64 timeMs{};
+        source_index_t sourceIndex{};
+        SourcePositionMailboxes::Message message{};
+    };
+
+private:
+    struct PendingEvent {
+        Event event{};
+        std::uint32_t generation{};
+        std::uint64_t order{};
+    };
+
+    juce::AbstractFifo mFifo{ CAPACITY };
+    std::array<PendingEvent, CAPACITY> mFifoEvents{};
+    // Indexed by source index (minus the offset). Bumped by discard().
+    std::array<std::atomic<std::uint32_t>, MAX_NUM_SOURCES> mGenerations{};
+    // Consumer only.
+    std::vector<PendingEvent> mPendingEvents{};
+    std::uint64_t mNextOrder{};
+
+public:
+    //==============================================================================
+    PositionSchedule();
+    ~PositionSchedule() = default;
+    SG_DELETE_COPY_AND_MOVE(PositionSchedule)
+    //==============================================================================
+    /** Producer thread : returns false if the schedule is full. Never blocks. The caller is expected to check the time
+     * with isWithinHorizon() first. */
+    [[nodiscard]] bool schedule(Event const & event) noexcept;
+    /** Any thread : the events scheduled for a source up to now will never be released. Never blocks. */
+    void discard(source_index_t sourceIndex) noexcept;
+    /** Consumer thread : calls callback(Event const &) with every event due at timeMs, in time order. Returns the time
+     * of the next event still pending, if any.
+     */
+    template<typename Callback>
+    tl::optional<juce::int64> releaseDue(juce::int64 timeMs, Callback && callback);
+    //==============================================================================
+    /** Whether an event at timeMs is close enough to nowMs to be scheduled. */
+    [[nodiscard]] static constexpr bool isWithinHorizon(juce::int64 const timeMs, juce::int64 const nowMs) noexcept
+    {
+        return timeMs - nowMs <= MAX_AHEAD_MS;
+    }
+
+private:
+    //==============================================================================
+    /** Moves the events out of the FIFO into the heap. */
+    void collectScheduled() noexcept;
+    [[nodiscard]] bool isDiscarded(PendingEvent const & pendingEvent) const noexcept;
+    [[nodiscard]] static bool comesAfter(PendingEvent const & a, PendingEvent const & b) noexcept;
+    [[nodiscard]] static size_t toIndex(source_index_t sourceIndex) noexcept;
+    //==============================================================================
+    JUCE_LEAK_DETECTOR(PositionSchedule)
+};
+
+//==============================================================================
+template<typename Callback>
+tl::optional<juce::int64> PositionSchedule::releaseDue(juce::int64 const timeMs, Callback && callback)
+{
+    collectScheduled();
+
+    while (!mPendingEvents.empty() && mPendingEvents.front().event.timeMs <= timeMs) {
+        std::pop_heap(mPendingEvents.begin(), mPendingEvents.end(), comesAfter);
+        auto const pendingEvent{ mPendingEvents.back() };
+        mPendingEvents.pop_back();
+        if (!isDiscarded(pendingEvent)) {
+            callback(pendingEvent.event);
+        }
+    }
+
+    if (mPendingEvents.empty()) {
+        return tl::nullopt;
+    }
+    return mPendingEvents.front().event.timeMs;
+}
+
+} // namespace gris
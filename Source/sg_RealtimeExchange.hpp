@@ -0,0 +1,108 @@
+/*
+ This file is part of SpatGRIS.
+
+ Developers: Gaël Lane Lépine, Samuel Béland, Olivier Bélanger, Nicolas Masson
+
+ SpatGRIS is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ SpatGRIS is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with SpatGRIS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Data/sg_Macros.hpp"
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <memory>
+
+namespace gris
+{
+//==============================================================================
+/** Hands heap-allocated objects over from a single producer thread to the audio thread.
+ *
+ * The producer publishes a complete object with publish(). At the start of a block, the audio thread picks up the most
+ * recent one with acquire(), swaps its content with what it was using, and gives the object back with retire(). Neither
+ * call blocks, allocates or frees memory : retired objects are deleted by the producer on its next call to publish()
+ * or collectGarbage().
+ */
+template<typename T>
+class RealtimeExchange
+{
+    static constexpr auto RETIRED_CAPACITY = 32;
+
+    std::atomic<T *> mPending{};
+    juce::AbstractFifo mRetiredFifo{ RETIRED_CAPACITY };
+    std::array<T *, RETIRED_CAPACITY> mRetired{};
+
+public:
+    //==============================================================================
+    RealtimeExchange() = default;
+    ~RealtimeExchange()
+    {
+        collectGarbage();
+        delete mPending.exchange(nullptr);
+    }
+    SG_DELETE_COPY_AND_MOVE(RealtimeExchange)
+    //==============================================================================
+    /** Producer : makes an object available to the audio thread. Any previous object that was not picked up yet is
+     * dropped, so use takeBackPending() first if its content has to be merged into the new one. */
+    void publish(std::unique_ptr<T> object)
+    {
+        collectGarbage();
+        std::unique_ptr<T> const skipped{ mPending.exchange(object.release(), std::memory_order_acq_rel) };
+    }
+    /** Producer : gets back the published object if the audio thread did not pick it up yet. */
+    [[nodiscard]] std::unique_ptr<T> takeBackPending() noexcept
+    {
+        return std::unique_ptr<T>{ mPending.exchange(nullptr, std::memory_order_acq_rel) };
+    }
+    /** Producer : deletes the objects given back by the audio thread. */
+    void collectGarbage()
+    {
+        auto const scope{ mRetiredFifo.read(mRetiredFifo.getNumReady()) };
+        scope.forEach([this](int const index) {
+            delete mRetired[static_cast<size_t>(index)];
+            mRetired[static_cast<size_t>(index)] = nullptr;
+        });
+    }
+    //==============================================================================
+    /** Audio thread : returns the most recent object, or nullptr if nothing new was published. Every non-null object
+     * has to be handed back with retire() before the next call. */
+    [[nodiscard]] T * acquire() noexcept
+    {
+        if (mPending.load(std::memory_order_relaxed) == nullptr) {
+            return nullptr;
+        }
+        // If the producer has not been collecting the garbage, keep using the current object for now rather than
+        // having nowhere to put the retired one.
+        if (mRetiredFifo.getFreeSpace() == 0) {
+            return nullptr;
+        }
+        return mPending.exchange(nullptr, std::memory_order_acq_rel);
+    }
+    /** Audio thread : hands back an object obtained with acquire(). */
+    void retire(T * object) noexcept
+    {
+        jassert(object != nullptr);
+        auto const scope{ mRetiredFifo.write(1) };
+        jassert(scope.blockSize1 == 1);
+        mRetired[static_cast<size_t>(scope.startIndex1)] = object;
+    }
+
+private:
+    //==============================================================================
+    JUCE_LEAK_DETECTOR(RealtimeExchange)
+};
+
+} // namespace gris
@@ -127,6 +127,16 @@ SettingsComponent::SettingsComponent(MainContentComponent & parent,
     initLabel(mBufferSize);
     initComboBox(mBufferSizeCombo);
 
+    initLabel(mSourceGatingLabel);
+    mSourceGatingToggleButton.setTooltip("Keeps the sources that stay silent out of the spatialization");
+    mSourceGatingToggleButton.setToggleState(mMainContentComponent.getAudioProcessor().isSourceGatingEnabled(),
+                                             juce::dontSendNotification);
+    mSourceGatingToggleButton.setBounds(0, 0, RIGHT_COL_WIDTH, COMPONENT_HEIGHT);
+    mSourceGatingToggleButton.addListener(this);
+    mSourceGatingToggleButton.setColour(juce::ToggleButton::textColourId, mLookAndFeel.getFontColour());
+    mSourceGatingToggleButton.setLookAndFeel(&mLookAndFeel);
+    addAndMakeVisible(mSourceGatingToggleButton);
+
     //==============================================================================
     initSectionLabel(mSpatNetworkSettings);
 
@@ -232,6 +242,8 @@ void SettingsComponent::buttonClicked(juce::Button * button)
         if (isSelectedAudioDeviceActive()) {
             mMainContentComponent.closePropertiesWindow();
         }
+    } else if (button == &mSourceGatingToggleButton) {
+        mMainContentComponent.setSourceGating(mSourceGatingToggleButton.getToggleState());
     }
 }
 
@@ -265,6 +277,10 @@ void SettingsComponent::placeComponents()
 
     mBufferSize.setTopLeftPosition(LEFT_COL_START, yPosition);
     mBufferSizeCombo.setTopLeftPosition(RIGHT_COL_START, yPosition);
+    addLineGap();
+
+    mSourceGatingLabel.setTopLeftPosition(LEFT_COL_START, yPosition);
+    mSourceGatingToggleButton.setTopLeftPosition(RIGHT_COL_START, yPosition);
     addSectionGap();
 
     //==============================================================================
@@ -386,8 +402,6 @@ void SettingsComponent::comboBoxChanged(juce::ComboBox * comboBoxThatHasChanged)
         audioDeviceManager.getCurrentDeviceTypeObject()->hasSeparateInputsAndOutputs()
     };
 
-    juce::ScopedLock const lock{ mMainContentComponent.getAudioProcessor().getLock() };
-
     if (comboBoxThatHasChanged == &mDeviceTypeCombo) {
         audioDeviceManager.setCurrentAudioDeviceType(comboBoxThatHasChanged->getText(), true);
     } else if (comboBoxThatHasChanged == &mInputDeviceCombo) {
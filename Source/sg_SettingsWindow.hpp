@@ -67,6 +67,9 @@ class SettingsComponent final
     juce::Label mBufferSize{ "", "Buffer Size (spls) :" };
     juce::ComboBox mBufferSizeCombo;
 
+    juce::Label mSourceGatingLabel{ "", "Silent sources :" };
+    juce::ToggleButton mSourceGatingToggleButton{ "Skip" };
+
     //==============================================================================
     juce::Label mSpatNetworkSettings{ "", "Spatialization Data Network Settings" };
 
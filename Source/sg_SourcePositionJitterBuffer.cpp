@@ -0,0 +1,356 @@
+/*
+ This file is part of SpatGRIS.
+
+ Developers: Gaël Lane Lépine, Samuel Béland, Olivier Bélanger, Nicolas Masson
+
+ SpatGRIS is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ SpatGRIS is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with SpatGRIS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sg_SourcePositionJitterBuffer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+namespace
+{
+/** A longer silence starts a new movement instead of counting as an interval. */
+constexpr double MAX_INTERVAL_MS = 500.0;
+/** Closer to the center, a cartesian position has no direction to turn around : it moves in a straight line. */
+constexpr float MIN_RADIUS = 1e-4f;
+
+using Message = gris::SourcePositionMailboxes::Message;
+using Kind = gris::SourcePositionMailboxes::Kind;
+using Vector = std::array<float, 3>;
+/** The change of the three coordinates, the two spans and, for cartesian positions, the radius.
+ *
+ * Legacy positions are already polar : their three coordinates change linearly and the last slot is unused. Cartesian
+ * positions turn around the center instead, so that a source going from one side of the dome to the other does not
+ * cut through it : the first three slots are then the rotation, as its axis multiplied by its angle in radians, and the
+ * last one is the change of the radius. Starting from the center, where there is no direction, they are the plain
+ * differences of the coordinates.
+ */
+using Delta = std::array<float, 6>;
+
+//==============================================================================
+float dot(Vector const & a, Vector const & b) noexcept
+{
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+//==============================================================================
+Vector cross(Vector const & a, Vector const & b) noexcept
+{
+    return { a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+}
+
+//==============================================================================
+float length(Vector const & vector) noexcept
+{
+    return std::sqrt(dot(vector, vector));
+}
+
+//==============================================================================
+bool isAtCenter(Message const & message) noexcept
+{
+    return message.kind == Kind::cartesian && length(message.coordinates) < MIN_RADIUS;
+}
+
+//==============================================================================
+/** The rotation, as its axis multiplied by its angle, that brings the direction of from onto the direction of to. */
+Vector rotationBetween(Vector const & from, Vector const & to) noexcept
+{
+    auto const axis{ cross(from, to) };
+    auto const sine{ length(axis) };
+    auto const cosine{ dot(from, to) };
+    auto const angle{ std::atan2(sine, cosine) };
+    if (sine > MIN_RADIUS * std::abs(cosine)) {
+        auto const scale{ angle / sine };
+        return { axis[0] * scale, axis[1] * scale, axis[2] * scale };
+    }
+    if (cosine >= 0.0f) {
+        // Same direction.
+        return {};
+    }
+    // Opposite directions : every axis perpendicular to from is as short. The one that also is perpendicular to the
+    // axis of its smallest coordinate is never degenerate.
+    auto const smallest{ static_cast<size_t>(
+        std::distance(from.cbegin(), std::min_element(from.cbegin(), from.cend(), [](float const a, float const b) {
+                          return std::abs(a) < std::abs(b);
+                      }))) };
+    Vector unit{};
+    unit[smallest] = 1.0f;
+    auto const perpendicular{ cross(from, unit) };
+    auto const scale{ juce::MathConstants<float>::pi / length(perpendicular) };
+    return { perpendicular[0] * scale, perpendicular[1] * scale, perpendicular[2] * scale };
+}
+
+//==============================================================================
+/** Rodrigues' rotation formula. */
+Vector rotate(Vector const & vector, Vector const & rotation) noexcept
+{
+    auto const angle{ length(rotation) };
+    if (angle == 0.0f) {
+        return vector;
+    }
+    Vector const axis{ rotation[0] / angle, rotation[1] / angle, rotation[2] / angle };
+    auto const cosine{ std::cos(angle) };
+    auto const sine{ std::sin(angle) };
+    auto const axial{ dot(axis, vector) * (1.0f - cosine) };
+    auto const perpendicular{ cross(axis, vector) };
+    return { vector[0] * cosine + perpendicular[0] * sine + axis[0] * axial,
+             vector[1] * cosine + perpendicular[1] * sine + axis[1] * axial,
+             vector[2] * cosine + perpendicular[2] * sine + axis[2] * axial };
+}
+
+//==============================================================================
+Delta difference(Message const & from, Message const & to) noexcept
+{
+    Delta delta{ to.coordinates[0] - from.coordinates[0],
+                 to.coordinates[1] - from.coordinates[1],
+                 to.coordinates[2] - from.coordinates[2],
+                 to.azimuthSpan - from.azimuthSpan,
+                 to.zenithSpan - from.zenithSpan,
+                 0.0f };
+    if (from.kind == Kind::legacy) {
+        // The shortest way around.
+        delta[0] = std::remainder(delta[0], juce::MathConstants<float>::twoPi);
+        return delta;
+    }
+    auto const fromRadius{ length(from.coordinates) };
+    auto const toRadius{ length(to.coordinates) };
+    delta[5] = toRadius - fromRadius;
+    if (fromRadius < MIN_RADIUS) {
+        return delta;
+    }
+    // Heading to the center is a straight line as well, which no rotation at all gives.
+    auto const rotation{ toRadius < MIN_RADIUS ? Vector{} : rotationBetween(from.coordinates, to.coordinates) };
+    std::copy(rotation.cbegin(), rotation.cend(), delta.begin());
+    return delta;
+}
+
+//==============================================================================
+Message offset(Message message, Delta const & delta, float const factor) noexcept
+{
+    if (message.kind == Kind::legacy || isAtCenter(message)) {
+        for (size_t i{}; i < message.coordinates.size(); ++i) {
+            message.coordinates[i] += delta[i] * factor;
+        }
+    } else {
+        auto const radius{ length(message.coordinates) };
+        auto const newRadius{ std::max(radius + delta[5] * factor, 0.0f) };
+        Vector const rotation{ delta[0] * factor, delta[1] * factor, delta[2] * factor };
+        auto const direction{ rotate(message.coordinates, rotation) };
+        for (size_t i{}; i < message.coordinates.size(); ++i) {
+            message.coordinates[i] = direction[i] * newRadius / radius;
+        }
+    }
+    if (message.kind == Kind::legacy) {
+        message.coordinates[2] = std::max(message.coordinates[2], 0.0f);
+    }
+    message.azimuthSpan = std::clamp(message.azimuthSpan + delta[3] * factor, 0.0f, 1.0f);
+    message.zenithSpan = std::clamp(message.zenithSpan + delta[4] * factor, 0.0f, 1.0f);
+    return message;
+}
+
+} // namespace
+
+namespace gris
+{
+//==============================================================================
+void SourcePositionJitterBuffer::setDelayMs(int const delayMs) noexcept
+{
+    mDelayMs.store(std::clamp(delayMs, 0, MAX_DELAY_MS));
+}
+
+//==============================================================================
+bool SourcePositionJitterBuffer::push(source_index_t const sourceIndex,
+                                      Message const & message,
+                                      double const arrivalTimeMs) noexcept
+{
+    auto const scope{ mFifo.write(1) };
+    if (scope.blockSize1 == 0) {
+        return false;
+    }
+    mFifoArrivals[static_cast<size_t>(scope.startIndex1)] = Arrival{ arrivalTimeMs, sourceIndex, message };
+    return true;
+}
+
+//==============================================================================
+void SourcePositionJitterBuffer::discard(source_index_t const sourceIndex) noexcept
+{
+    collectArrivals();
+    auto & source{ mSources[toIndex(sourceIndex)] };
+    if (source.isActive) {
+        deactivate(source);
+    }
+    source.numArrivals = 0;
+    source.lastReached = tl::nullopt;
+}
+
+//==============================================================================
+void SourcePositionJitterBuffer::collectArrivals() noexcept
+{
+    auto const numReady{ mFifo.getNumReady() };
+    if (numReady == 0) {
+        return;
+    }
+
+    auto const scope{ mFifo.read(numReady) };
+    scope.forEach([this](int const index) { addArrival(mFifoArrivals[static_cast<size_t>(index)]); });
+}
+
+//==============================================================================
+void SourcePositionJitterBuffer::addArrival(Arrival const & arrival) noexcept
+{
+    auto & source{ mSources[toIndex(arrival.sourceIndex)] };
+    auto const delayMs{ static_cast<double>(getDelayMs()) };
+
+    auto const lastArrivalIndex{ (source.nextArrival + SourceState::INTERVAL_WINDOW - 1)
+                                 % SourceState::INTERVAL_WINDOW };
+    if (source.numArrivals == 0 || arrival.timeMs - source.arrivalTimesMs[lastArrivalIndex] > MAX_INTERVAL_MS) {
+        // A new movement : the previous messages tell nothing about this one.
+        source.numArrivals = 0;
+        source.intervalMs = 0.0;
+        source.lastPlaybackTimeMs = std::numeric_limits<double>::lowest();
+        source.lastReached = tl::nullopt;
+    }
+    if (!source.isActive) {
+        source.isActive = true;
+        source.firstSample = 0;
+        source.numSamples = 0;
+        // After a short stop, the source glides from where it stopped instead of waiting to jump to the next position.
+        source.output = tl::nullopt;
+        if (source.lastReached) {
+            source.output = Sample{ arrival.timeMs, source.lastReached->message };
+        }
+        ++mNumActiveSources;
+    }
+
+    // Averaged over a few messages, so that the short intervals inside a burst and the long ones between two bursts
+    // even out.
+    if (source.numArrivals > 0) {
+        auto const oldestIndex{ (source.nextArrival + SourceState::INTERVAL_WINDOW - source.numArrivals)
+                                % SourceState::INTERVAL_WINDOW };
+        source.intervalMs = (arrival.timeMs - source.arrivalTimesMs[oldestIndex])
+                            / static_cast<double>(source.numArrivals);
+    }
+    source.arrivalTimesMs[source.nextArrival] = arrival.timeMs;
+    source.nextArrival = (source.nextArrival + 1) % SourceState::INTERVAL_WINDOW;
+    source.numArrivals = std::min(source.numArrivals + 1, SourceState::INTERVAL_WINDOW);
+
+    // A burst gets spread back over the usual interval, but never waits more than twice the delay. A position can
+    // not be played before the previous one either, even if the delay was shortened since.
+    auto const playbackTimeMs{ std::max(std::clamp(source.lastPlaybackTimeMs + source.intervalMs,
+                                                   arrival.timeMs + delayMs,
+                                                   arrival.timeMs + 2.0 * delayMs),
+                                        source.lastPlaybackTimeMs) };
+    source.lastPlaybackTimeMs = playbackTimeMs;
+
+    if (source.numSamples == SourceState::CAPACITY) {
+        // Way more messages than needed : the oldest one is simply reached early.
+        reach(source, source.samples[source.firstSample]);
+        source.firstSample = (source.firstSample + 1) % SourceState::CAPACITY;
+        --source.numSamples;
+    }
+    source.samples[(source.firstSample + source.numSamples) % SourceState::CAPACITY]
+        = Sample{ playbackTimeMs, arrival.message };
+    ++source.numSamples;
+}
+
+//==============================================================================
+tl::optional<SourcePositionJitterBuffer::Message> SourcePositionJitterBuffer::advance(SourceState & source,
+                                                                                      double const timeMs) noexcept
+{
+    while (source.numSamples > 0 && source.samples[source.firstSample].timeMs <= timeMs) {
+        reach(source, source.samples[source.firstSample]);
+        source.firstSample = (source.firstSample + 1) % SourceState::CAPACITY;
+        --source.numSamples;
+    }
+
+    if (source.numSamples > 0) {
+        if (!source.output) {
+            // The first position of the movement is not due yet.
+            return tl::nullopt;
+        }
+        auto const & from{ *source.output };
+        auto const & to{ source.samples[source.firstSample] };
+        if (from.message.kind != to.message.kind) {
+            // Nothing in between : the new position is applied once it is due.
+            return tl::nullopt;
+        }
+        // The arrivals are collected after the time was read : the output can start slightly after timeMs.
+        auto const spanMs{ to.timeMs - from.timeMs };
+        auto const ratio{ spanMs > 0.0 ? std::clamp(static_cast<float>((timeMs - from.timeMs) / spanMs), 0.0f, 1.0f)
+                                       : 1.0f };
+        auto const message{ offset(from.message, difference(from.message, to.message), ratio) };
+        source.output = Sample{ std::max(timeMs, from.timeMs), message };
+        return message;
+    }
+
+    // Nothing left to reach : keep going for one interval in case the next position is late, then come back.
+    jassert(source.lastReached);
+    auto const & last{ *source.lastReached };
+    auto const horizonMs{ std::min(source.intervalMs, static_cast<double>(getDelayMs())) };
+    auto const elapsedMs{ std::max(timeMs - last.timeMs, 0.0) };
+    if (elapsedMs >= 2.0 * horizonMs) {
+        deactivate(source);
+        return last.message;
+    }
+    auto const extrapolatedMs{ elapsedMs <= horizonMs ? elapsedMs : 2.0 * horizonMs - elapsedMs };
+    auto const message{ offset(last.message, source.velocity, static_cast<float>(extrapolatedMs)) };
+    source.output = Sample{ timeMs, message };
+    return message;
+}
+
+//==============================================================================
+void SourcePositionJitterBuffer::reach(SourceState & source, Sample const & sample) noexcept
+{
+    source.velocity = {};
+    if (source.lastReached && source.lastReached->message.kind == sample.message.kind) {
+        auto const durationMs{ static_cast<float>(sample.timeMs - source.lastReached->timeMs) };
+        if (durationMs > 0.0f) {
+            source.velocity = difference(source.lastReached->message, sample.message);
+            if (isAtCenter(source.lastReached->message)) {
+                // Leaving the center is a straight line outward : past the last position, only the radius keeps
+                // growing.
+                std::fill_n(source.velocity.begin(), 3, 0.0f);
+            }
+            for (auto & value : source.velocity) {
+                value /= durationMs;
+            }
+        }
+    }
+    source.lastReached = sample;
+    source.output = sample;
+}
+
+//==============================================================================
+void SourcePositionJitterBuffer::deactivate(SourceState & source) noexcept
+{
+    jassert(source.isActive);
+    source.isActive = false;
+    source.numSamples = 0;
+    --mNumActiveSources;
+}
+
+//==============================================================================
+size_t SourcePositionJitterBuffer::toIndex(source_index_t const sourceIndex) noexcept
+{
+    auto const index{ static_cast<size_t>(sourceIndex.get() - source_index_t::OFFSET) };
+    jassert(index < MAX_NUM_SOURCES);
+    return index;
+}
+
+} // namespace gris
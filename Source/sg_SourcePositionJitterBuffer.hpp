@@ -0,0 +1,161 @@
+/*
+ This file is part of SpatGRIS.
+
+ Developers: Gaël Lane Lépine, Samuel Béland, Olivier Bélanger, Nicolas Masson
+
+ SpatGRIS is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ SpatGRIS is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with SpatGRIS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Data/StrongTypes/sg_SourceIndex.hpp"
+#include "Data/sg_Macros.hpp"
+#include "Data/sg_constants.hpp"
+#include "sg_SourcePositionMailboxes.hpp"
+#include "tl/optional.hpp"
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <limits>
+
+namespace gris
+{
+//==============================================================================
+/** Delays the positions received for each source a little, to play them back as a smooth motion.
+ *
+ * Controllers on Wi-Fi send their positions in bursts : a few of them at once, then nothing for a while. Applied as
+ * they arrive, the sources jump. Each position is instead given a playback time, at least the delay after its
+ * arrival and, for positions that arrive together, spaced by the usual interval of the source's messages. Between two
+ * positions, a legacy (polar) position moves linearly in azimuth, elevation and length, and a cartesian one turns
+ * around the center along the great circle while its radius changes linearly, so that it keeps to the dome instead
+ * of cutting through it. When the next position is late, the source keeps going at the same speed (the same angular
+ * speed for cartesian positions) for one interval, then comes back to the last position it received if nothing came
+ * in the meantime.
+ *
+ * Only the positions are smoothed : the gains are still interpolated by the audio processor on top of that.
+ *
+ * The OSC thread pushes the positions through a lock-free FIFO and never waits. Everything else is done by the
+ * consumer, whose calls have to be serialized by the caller. All times are in milliseconds, as given by
+ * juce::Time::getMillisecondCounterHiRes().
+ */
+class SourcePositionJitterBuffer
+{
+public:
+    using Message = SourcePositionMailboxes::Message;
+
+    static constexpr auto FIFO_CAPACITY = 4096;
+    static constexpr auto MAX_DELAY_MS = 200;
+
+private:
+    //==============================================================================
+    struct Arrival {
+        double timeMs{};
+        source_index_t sourceIndex{};
+        Message message{};
+    };
+    //==============================================================================
+    struct Sample {
+        double timeMs{};
+        Message message{};
+    };
+    //==============================================================================
+    struct SourceState {
+        static constexpr size_t CAPACITY = 32;
+        static constexpr size_t INTERVAL_WINDOW = 8;
+
+        bool isActive{};
+        /** The positions not reached yet, in playback order. A ring buffer. */
+        std::array<Sample, CAPACITY> samples{};
+        size_t firstSample{};
+        size_t numSamples{};
+        /** The arrival times of the last messages, to tell the usual interval between two of them. A ring buffer. */
+        std::array<double, INTERVAL_WINDOW> arrivalTimesMs{};
+        size_t nextArrival{};
+        size_t numArrivals{};
+        double lastPlaybackTimeMs{};
+        /** Average time between two messages of the source, 0 until known. */
+        double intervalMs{};
+        /** The last position reached and the speed at which the source got there, per millisecond. */
+        tl::optional<Sample> lastReached{};
+        std::array<float, 6> velocity{};
+        /** The last position handed to the callback. */
+        tl::optional<Sample> output{};
+    };
+    //==============================================================================
+    std::atomic<int> mDelayMs{};
+    juce::AbstractFifo mFifo{ FIFO_CAPACITY };
+    std::array<Arrival, FIFO_CAPACITY> mFifoArrivals{};
+    // Consumer only.
+    std::array<SourceState, MAX_NUM_SOURCES> mSources{};
+    int mNumActiveSources{};
+
+public:
+    //==============================================================================
+    SourcePositionJitterBuffer() = default;
+    ~SourcePositionJitterBuffer() = default;
+    SG_DELETE_COPY_AND_MOVE(SourcePositionJitterBuffer)
+    //==============================================================================
+    /** Any thread : 0 disables the buffer. The positions already buffered are then applied right away. */
+    void setDelayMs(int delayMs) noexcept;
+    [[nodiscard]] int getDelayMs() const noexcept { return mDelayMs.load(); }
+    [[nodiscard]] bool isEnabled() const noexcept { return getDelayMs() > 0; }
+    /** Producer thread : returns false if the FIFO is full. Never blocks. */
+    [[nodiscard]] bool push(source_index_t sourceIndex, Message const & message, double arrivalTimeMs) noexcept;
+    /** Consumer : calls callback(source_index_t, Message const &) with the current position of every source that is
+     * moving. Returns true as long as some source still has to be updated.
+     */
+    template<typename Callback>
+    bool process(double timeMs, Callback && callback);
+    /** Consumer : forgets every position received for a source up to now. */
+    void discard(source_index_t sourceIndex) noexcept;
+
+private:
+    //==============================================================================
+    /** Moves the positions out of the FIFO and gives them their playback time. */
+    void collectArrivals() noexcept;
+    void addArrival(Arrival const & arrival) noexcept;
+    /** The position of a source at a given time, if there is one. Deactivates the source once it is done moving. */
+    [[nodiscard]] tl::optional<Message> advance(SourceState & source, double timeMs) noexcept;
+    static void reach(SourceState & source, Sample const & sample) noexcept;
+    void deactivate(SourceState & source) noexcept;
+    [[nodiscard]] static size_t toIndex(source_index_t sourceIndex) noexcept;
+    //==============================================================================
+    JUCE_LEAK_DETECTOR(SourcePositionJitterBuffer)
+};
+
+//==============================================================================
+template<typename Callback>
+bool SourcePositionJitterBuffer::process(double const timeMs, Callback && callback)
+{
+    collectArrivals();
+    if (mNumActiveSources == 0) {
+        return false;
+    }
+
+    // Once disabled, whatever is left goes straight to its last position.
+    auto const playbackTimeMs{ isEnabled() ? timeMs : std::numeric_limits<double>::max() };
+    for (size_t i{}; i < mSources.size(); ++i) {
+        auto & source{ mSources[i] };
+        if (!source.isActive) {
+            continue;
+        }
+        if (auto const message{ advance(source, playbackTimeMs) }) {
+            callback(source_index_t{ static_cast<int>(i) + source_index_t::OFFSET }, *message);
+        }
+    }
+    return mNumActiveSources > 0;
+}
+
+} // namespace gris
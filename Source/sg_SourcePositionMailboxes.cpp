@@ -0,0 +1,96 @@
+/*
+ This file is part of SpatGRIS.
+
+ Developers: Gaël Lane Lépine, Samuel Béland, Olivier Bélanger, Nicolas Masson
+
+ SpatGRIS is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ SpatGRIS is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with SpatGRIS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sg_SourcePositionMailboxes.hpp"
+
+#include <thread>
+
+namespace gris
+{
+//==============================================================================
+void SourcePositionMailboxes::post(source_index_t const sourceIndex, Message const & message) noexcept
+{
+    auto & mailbox{ mMailboxes[toIndex(sourceIndex)] };
+
+    // Single writer : nobody else can change the sequence number in the meantime.
+    auto const sequence{ mailbox.sequence.load(std::memory_order_relaxed) };
+    mailbox.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    mailbox.kind.store(message.kind, std::memory_order_relaxed);
+    for (size_t i{}; i < message.coordinates.size(); ++i) {
+        mailbox.coordinates[i].store(message.coordinates[i], std::memory_order_relaxed);
+    }
+    mailbox.azimuthSpan.store(message.azimuthSpan, std::memory_order_relaxed);
+    mailbox.zenithSpan.store(message.zenithSpan, std::memory_order_relaxed);
+
+    mailbox.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+//==============================================================================
+bool SourcePositionMailboxes::collect(source_index_t const sourceIndex, Message & message) noexcept
+{
+    auto const index{ toIndex(sourceIndex) };
+    auto const & mailbox{ mMailboxes[index] };
+
+    while (true) {
+        auto const sequence{ mailbox.sequence.load(std::memory_order_acquire) };
+        if (sequence == mCollectedSequences[index]) {
+            return false;
+        }
+        if (sequence % 2 != 0) {
+            // The writer is in the middle of a message : it only takes a few stores.
+            std::this_thread::yield();
+            continue;
+        }
+
+        message.kind = mailbox.kind.load(std::memory_order_relaxed);
+        for (size_t i{}; i < message.coordinates.size(); ++i) {
+            message.coordinates[i] = mailbox.coordinates[i].load(std::memory_order_relaxed);
+        }
+        message.azimuthSpan = mailbox.azimuthSpan.load(std::memory_order_relaxed);
+        message.zenithSpan = mailbox.zenithSpan.load(std::memory_order_relaxed);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (mailbox.sequence.load(std::memory_order_relaxed) == sequence) {
+            mCollectedSequences[index] = sequence;
+            return true;
+        }
+        // Overwritten while reading : try again with the newer message.
+    }
+}
+
+//==============================================================================
+void SourcePositionMailboxes::discard(source_index_t const sourceIndex) noexcept
+{
+    auto const index{ toIndex(sourceIndex) };
+    auto const sequence{ mMailboxes[index].sequence.load(std::memory_order_acquire) };
+    // An odd number means that a message is being written : it will be collected once it is done.
+    mCollectedSequences[index] = sequence & ~std::uint32_t{ 1 };
+}
+
+//==============================================================================
+size_t SourcePositionMailboxes::toIndex(source_index_t const sourceIndex) noexcept
+{
+    auto const index{ static_cast<size_t>(sourceIndex.get() - source_index_t::OFFSET) };
+    jassert(index < MAX_NUM_SOURCES);
+    return index;
+}
+
+} // namespace gris
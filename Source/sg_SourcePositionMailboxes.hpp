@@ -0,0 +1,99 @@
+/*
+ This file is part of SpatGRIS.
+
+ Developers: Gaël Lane Lépine, Samuel Béland, Olivier Bélanger, Nicolas Masson
+
+ SpatGRIS is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ SpatGRIS is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with SpatGRIS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Data/StrongTypes/sg_SourceIndex.hpp"
+#include "Data/sg_Macros.hpp"
+#include "Data/sg_constants.hpp"
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace gris
+{
+//==============================================================================
+/** The last position received for each source, shared between the OSC thread and the spat data updater without
+ * any lock.
+ *
+ * Every source has its own mailbox. The OSC thread is its only writer and simply overwrites whatever the mailbox
+ * holds : only the newest position matters. The mailbox is a sequence lock : the writer makes the sequence number
+ * odd while it writes and even again when it is done, so a reader that saw the same even number before and after
+ * reading knows that it got a consistent message. The writer never waits on anybody.
+ */
+class SourcePositionMailboxes
+{
+public:
+    //==============================================================================
+    /** How the three coordinates of a message are to be interpreted. */
+    enum class Kind : std::uint32_t {
+        /** Cartesian x, y and z. */
+        cartesian,
+        /** Azimuth and elevation in radians and a length, as sent by the legacy "/spat/serv" messages. */
+        legacy
+    };
+    //==============================================================================
+    struct Message {
+        Kind kind{};
+        std::array<float, 3> coordinates{};
+        float azimuthSpan{};
+        float zenithSpan{};
+    };
+
+private:
+    //==============================================================================
+    struct Mailbox {
+        std::atomic<std::uint32_t> sequence{};
+        std::atomic<Kind> kind{};
+        std::array<std::atomic<float>, 3> coordinates{};
+        std::atomic<float> azimuthSpan{};
+        std::atomic<float> zenithSpan{};
+    };
+    //==============================================================================
+    std::array<Mailbox, MAX_NUM_SOURCES> mMailboxes{};
+    // Reader side only.
+    std::array<std::uint32_t, MAX_NUM_SOURCES> mCollectedSequences{};
+
+public:
+    //==============================================================================
+    SourcePositionMailboxes() = default;
+    ~SourcePositionMailboxes() = default;
+    SG_DELETE_COPY_AND_MOVE(SourcePositionMailboxes)
+    //==============================================================================
+    /** Writer thread : replaces the message of a source. Never blocks. */
+    void post(source_index_t sourceIndex, Message const & message) noexcept;
+    /** Reader side : the message of a source, if it changed since the previous call.
+     *
+     * The reader side is not thread-safe in itself : every call to collect() and discard() has to be serialized by
+     * the caller.
+     */
+    [[nodiscard]] bool collect(source_index_t sourceIndex, Message & message) noexcept;
+    /** Reader side : forgets whatever message is waiting for a source, so that it won't be collected. */
+    void discard(source_index_t sourceIndex) noexcept;
+
+private:
+    //==============================================================================
+    [[nodiscard]] static size_t toIndex(source_index_t sourceIndex) noexcept;
+    //==============================================================================
+    JUCE_LEAK_DETECTOR(SourcePositionMailboxes)
+};
+
+} // namespace gris
@@ -0,0 +1,139 @@
+/*
+ This file is part of SpatGRIS.
+
+ Developers: Gaël Lane Lépine, Samuel Béland, Olivier Bélanger, Nicolas Masson
+
+ SpatGRIS is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ SpatGRIS is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with SpatGRIS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sg_SpatAlgorithmBuilder.hpp"
+
+#include "sg_ParallelHybridSpatAlgorithm.hpp"
+
+namespace gris
+{
+//==============================================================================
+SpatAlgorithmBuilder::SpatAlgorithmBuilder(Callback callback)
+    : juce::Thread("SpatGRIS spat algorithm builder")
+    , mCallback(std::move(callback))
+{
+    jassert(mCallback);
+    startThread();
+}
+
+//==============================================================================
+SpatAlgorithmBuilder::~SpatAlgorithmBuilder()
+{
+    JUCE_ASSERT_MESSAGE_THREAD;
+    cancelPendingUpdate();
+    // A build that is under way cannot be interrupted.
+    stopThread(-1);
+}
+
+//==============================================================================
+void SpatAlgorithmBuilder::requestBuild(Request request)
+{
+    JUCE_ASSERT_MESSAGE_THREAD;
+    {
+        juce::ScopedLock const lock{ mLock };
+        mPendingRequest = std::make_unique<Request>(std::move(request));
+        ++mLastRequestId;
+    }
+    notify();
+}
+
+//==============================================================================
+bool SpatAlgorithmBuilder::isBuilding() const noexcept
+{
+    JUCE_ASSERT_MESSAGE_THREAD;
+    juce::ScopedLock const lock{ mLock };
+    return mLastDeliveredId != mLastRequestId;
+}
+
+//==============================================================================
+std::unique_ptr<AbstractSpatAlgorithm> SpatAlgorithmBuilder::build(Request const & request)
+{
+    auto useMulticoreDSP{ request.useMulticoreDSP };
+    if (request.spatMode == SpatMode::hybrid && useMulticoreDSP) {
+        if (!request.stereoMode) {
+            return ParallelHybridSpatAlgorithm::make(request.speakerSetup,
+                                                     request.sources,
+                                                     request.sampleRate,
+                                                     request.bufferSize);
+        }
+        // The multicore hybrid algorithm from AbstractSpatAlgorithm::make() is slower than the single core one.
+        useMulticoreDSP = false;
+    }
+
+    return AbstractSpatAlgorithm::make(request.speakerSetup,
+                                       request.spatMode,
+                                       request.stereoMode,
+                                       request.sources,
+                                       request.sampleRate,
+                                       request.bufferSize,
+                                       useMulticoreDSP);
+}
+
+//==============================================================================
+void SpatAlgorithmBuilder::run()
+{
+    while (!threadShouldExit()) {
+        std::unique_ptr<Request> request{};
+        int requestId{};
+        {
+            juce::ScopedLock const lock{ mLock };
+            request = std::move(mPendingRequest);
+            requestId = mLastRequestId;
+        }
+
+        if (!request) {
+            wait(-1);
+            continue;
+        }
+
+        auto algorithm{ build(*request) };
+
+        {
+            juce::ScopedLock const lock{ mLock };
+            if (requestId != mLastRequestId) {
+                // Outdated : a newer request is already waiting. The algorithm is freed outside of the lock.
+                continue;
+            }
+            std::swap(mResult, algorithm);
+            mResultId = requestId;
+        }
+        triggerAsyncUpdate();
+    }
+}
+
+//==============================================================================
+void SpatAlgorithmBuilder::handleAsyncUpdate()
+{
+    JUCE_ASSERT_MESSAGE_THREAD;
+
+    std::unique_ptr<AbstractSpatAlgorithm> algorithm{};
+    {
+        juce::ScopedLock const lock{ mLock };
+        if (!mResult || mResultId != mLastRequestId) {
+            // Either already delivered or superseded while waiting for the message thread.
+            return;
+        }
+        algorithm = std::move(mResult);
+        mLastDeliveredId = mResultId;
+    }
+
+    mCallback(std::move(algorithm));
+}
+
+} // namespace gris
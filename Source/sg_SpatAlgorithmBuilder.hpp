@@ -0,0 +1,89 @@
+/*
+ This file is part of SpatGRIS.
+
+ Developers: Gaël Lane Lépine, Samuel Béland, Olivier Bélanger, Nicolas Masson
+
+ SpatGRIS is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ SpatGRIS is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with SpatGRIS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Data/sg_LogicStrucs.hpp"
+#include "Data/sg_Macros.hpp"
+#include "sg_AbstractSpatAlgorithm.hpp"
+
+#include <JuceHeader.h>
+#include <functional>
+
+namespace gris
+{
+//==============================================================================
+/** Builds spatialization algorithms on a background thread.
+ *
+ * Making an algorithm can take a while (VBAP triangulation, thread pools, etc.), so the message thread only takes a
+ * copy of what is needed and hands it over with requestBuild(). The finished algorithm is given back on the message
+ * thread. When requests come in faster than they can be built, only the most recent one is delivered.
+ */
+class SpatAlgorithmBuilder final
+    : private juce::Thread
+    , private juce::AsyncUpdater
+{
+public:
+    /** Everything AbstractSpatAlgorithm::make() needs, copied so that the message thread is free to keep editing. */
+    struct Request {
+        SpeakerSetup speakerSetup;
+        SpatMode spatMode;
+        tl::optional<StereoMode> stereoMode;
+        SourcesData sources;
+        double sampleRate;
+        int bufferSize;
+        bool useMulticoreDSP;
+    };
+    /** Called on the message thread with the most recently requested algorithm. */
+    using Callback = std::function<void(std::unique_ptr<AbstractSpatAlgorithm>)>;
+
+private:
+    Callback mCallback;
+    juce::CriticalSection mLock{};
+    // All guarded by mLock.
+    std::unique_ptr<Request> mPendingRequest{};
+    std::unique_ptr<AbstractSpatAlgorithm> mResult{};
+    int mLastRequestId{};
+    int mResultId{};
+    // Message thread only.
+    int mLastDeliveredId{};
+
+public:
+    //==============================================================================
+    explicit SpatAlgorithmBuilder(Callback callback);
+    ~SpatAlgorithmBuilder() override;
+    SG_DELETE_COPY_AND_MOVE(SpatAlgorithmBuilder)
+    //==============================================================================
+    /** Builds a new algorithm in the background, superseding any request that was not delivered yet. */
+    void requestBuild(Request request);
+    /** Returns true from the moment a build is requested until its algorithm is delivered. */
+    [[nodiscard]] bool isBuilding() const noexcept;
+    //==============================================================================
+    /** Builds an algorithm on the calling thread. */
+    [[nodiscard]] static std::unique_ptr<AbstractSpatAlgorithm> build(Request const & request);
+
+private:
+    //==============================================================================
+    void run() override;
+    void handleAsyncUpdate() override;
+    //==============================================================================
+    JUCE_LEAK_DETECTOR(SpatAlgorithmBuilder)
+};
+
+} // namespace gris
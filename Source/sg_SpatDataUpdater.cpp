@@ -0,0 +1,96 @@
+/*
+ This file is part of SpatGRIS.
+
+ Developers: Gaël Lane Lépine, Samuel Béland, Olivier Bélanger, Nicolas Masson
+
+ SpatGRIS is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ SpatGRIS is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with SpatGRIS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "sg_SpatDataUpdater.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace gris
+{
+//==============================================================================
+SpatDataUpdater::SpatDataUpdater(Callback callback)
+    : juce::Thread("SpatGRIS spat data updater")
+    , mCallback(std::move(callback))
+{
+    jassert(mCallback);
+    mBatch.ensureStorageAllocated(MAX_NUM_SOURCES);
+    startThread();
+}
+
+//==============================================================================
+SpatDataUpdater::~SpatDataUpdater()
+{
+    stopThread(-1);
+}
+
+//==============================================================================
+void SpatDataUpdater::markDirty(source_index_t const sourceIndex) noexcept
+{
+    auto const index{ static_cast<size_t>(sourceIndex.get() - source_index_t::OFFSET) };
+    jassert(index < mDirtySources.size());
+    mDirtySources[index].store(true);
+}
+
+//==============================================================================
+void SpatDataUpdater::wakeUp() noexcept
+{
+    if (!mHasDirtySources.exchange(true)) {
+        notify();
+    }
+}
+
+//==============================================================================
+void SpatDataUpdater::setBlockDuration(double const seconds) noexcept
+{
+    mBlockDurationMs.store(std::max(1, static_cast<int>(std::ceil(seconds * 1000.0))));
+}
+
+//==============================================================================
+void SpatDataUpdater::run()
+{
+    tl::optional<juce::int64> nextCallbackTimeMs{};
+    while (!threadShouldExit()) {
+        if (!mHasDirtySources.exchange(false)) {
+            if (!nextCallbackTimeMs) {
+                wait(-1);
+                continue;
+            }
+            auto const remainingMs{ *nextCallbackTimeMs - juce::Time::currentTimeMillis() };
+            if (remainingMs > 0) {
+                wait(static_cast<int>(std::min<juce::int64>(remainingMs, std::numeric_limits<int>::max())));
+                continue;
+            }
+        }
+
+        mBatch.clearQuick();
+        for (size_t i{}; i < mDirtySources.size(); ++i) {
+            if (mDirtySources[i].exchange(false)) {
+                mBatch.add(source_index_t{ static_cast<int>(i) + source_index_t::OFFSET });
+            }
+        }
+        nextCallbackTimeMs = mCallback(mBatch);
+
+        // Whatever comes in until then is only heard from the next block anyway.
+        sleep(mBlockDurationMs.load());
+    }
+}
+
+} // namespace gris
@@ -0,0 +1,84 @@
+/*
+ This file is part of SpatGRIS.
+
+ Developers: Gaël Lane Lépine, Samuel Béland, Olivier Bélanger, Nicolas Masson
+
+ SpatGRIS is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ SpatGRIS is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with SpatGRIS.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "Data/StrongTypes/sg_SourceIndex.hpp"
+#include "Data/sg_Macros.hpp"
+#include "Data/sg_constants.hpp"
+#include "tl/optional.hpp"
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <functional>
+
+namespace gris
+{
+//==============================================================================
+/** Recomputes the spatialization data of the sources that moved, in batches, on its own thread.
+ *
+ * A controller can send many positions for the same source during a single audio block, but only the last one is
+ * ever heard. Instead of computing the gains of every message, the OSC thread only flags the source with markDirty()
+ * (its position waiting in a SourcePositionMailboxes), then calls wakeUp() : once per position message, or once per
+ * batch message however many sources it moved. The updater thread then hands every flagged source to the callback at
+ * once, at most once per audio block.
+ *
+ * The callback can also ask to be called again at a given time, flagged sources or not, for positions that are
+ * scheduled in advance or smoothed over time.
+ */
+class SpatDataUpdater final : private juce::Thread
+{
+public:
+    /** Called on the updater thread with every source that changed since the previous batch, which can be empty.
+     * Returns when it has to be called again even if no source is flagged until then, in milliseconds since 1970.
+     */
+    using Callback = std::function<tl::optional<juce::int64>(juce::Array<source_index_t> const & sources)>;
+
+private:
+    Callback mCallback;
+    std::array<std::atomic<bool>, MAX_NUM_SOURCES> mDirtySources{};
+    std::atomic<bool> mHasDirtySources{};
+    std::atomic<int> mBlockDurationMs{ 10 };
+    // Updater thread only.
+    juce::Array<source_index_t> mBatch{};
+
+public:
+    //==============================================================================
+    explicit SpatDataUpdater(Callback callback);
+    SpatDataUpdater() = delete;
+    ~SpatDataUpdater() override;
+    SG_DELETE_COPY_AND_MOVE(SpatDataUpdater)
+    //==============================================================================
+    /** Any thread : the source will be updated with the batch that follows the next wakeUp(). Never blocks. */
+    void markDirty(source_index_t sourceIndex) noexcept;
+    /** Any thread : calls back with the next batch, even if no source is flagged. Never blocks. */
+    void wakeUp() noexcept;
+    /** The minimum time between two batches. */
+    void setBlockDuration(double seconds) noexcept;
+    [[nodiscard]] int getBlockDurationMs() const noexcept { return mBlockDurationMs.load(); }
+
+private:
+    //==============================================================================
+    void run() override;
+    //==============================================================================
+    JUCE_LEAK_DETECTOR(SpatDataUpdater)
+};
+
+} // namespace gris